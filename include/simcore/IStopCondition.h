@@ -38,9 +38,21 @@ namespace sim {
         enum class StopCode { NONE, OBJECTIVES_MISSED, OBJECTIVES_REACHED, SIM_ENDED };
 
 
+        /**
+         * The event which caused the stop. Conditions which localize the event between two samples set the
+         * interpolated time and value, otherwise the time of the step and the sampled value are set
+         */
+        struct Event {
+            bool valid = false;
+            double time = 0.0;
+            double value = 0.0;
+        };
+
+
     private:
 
         StopCode _code = StopCode::NONE;
+        Event _event{};
 
 
     public:
@@ -75,6 +87,7 @@ namespace sim {
         virtual void reset() {
 
             _code = StopCode::NONE;
+            _event = Event{};
 
         }
 
@@ -90,9 +103,32 @@ namespace sim {
         }
 
 
+        /**
+         * Returns the event which caused the stop (not valid, if no event has been recorded)
+         * @return Event
+         */
+        const Event &event() const {
+
+            return _event;
+
+        }
+
+
     protected:
 
 
+        /**
+         * Records the event which caused the stop
+         * @param time Time of the event
+         * @param value Value at the event
+         */
+        void setEvent(double time, double value) {
+
+            _event = {true, time, value};
+
+        }
+
+
         /**
          * Call stop command with given code
          * @param code Code to be set
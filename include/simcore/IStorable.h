@@ -29,6 +29,10 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <sstream>
+#include <cstddef>
+#include "data/DataType.h"
+#include "data/JsonFormat.h"
 
 
 #define ADD(vector, name, structure)                                            \
@@ -37,6 +41,9 @@
 #define ADD_PTR(vector, name, structure)                                        \
     vector.emplace_back(sim::data::createDataEntry(#name, (structure).name))    \
 
+#define DATA_FIELD(type, name)                                                                      \
+    sim::data::createFieldDescriptor<decltype(type::name)>(#name, offsetof(type, name))             \
+
 
 #include <vector>
 #include <string>
@@ -47,6 +54,38 @@ namespace data {
     struct IDataSet {
         virtual std::ostream &s(std::ostream &os) const = 0;
         virtual const void *v() const = 0;
+        virtual DataType type() const { return DataType::OTHER; }
+        virtual void json(std::string &out) const {
+            std::ostringstream os;
+            s(os);
+            out.append(os.str());
+        }
+    };
+
+
+    /**
+     * Describes a field of a structure by its name, its offset within the structure and its type
+     */
+    struct FieldDescriptor {
+        const char *name;
+        std::size_t offset;
+        DataType type;
+    };
+
+
+    /**
+     * A static descriptor table and the structure instance it is applied to
+     */
+    struct FieldTable {
+
+        const FieldDescriptor *fields = nullptr;
+        std::size_t size = 0;
+        const void *base = nullptr;
+
+        const void *pointer(std::size_t i) const {
+            return static_cast<const char*>(base) + fields[i].offset;
+        }
+
     };
 
 
@@ -66,10 +105,38 @@ namespace data {
 
 
         /**
-         * Returns a vector with data entries
+         * Returns the name of the context as used in value names (owner.context.name)
+         * @param context Context
+         * @return Name of the context
+         */
+        static const char *contextName(Context context) {
+
+            switch(context) {
+                case PARAMETER: return "parameter";
+                case INPUT:     return "input";
+                default:        return "state";
+            }
+
+        }
+
+
+        /**
+         * Returns a vector with data entries. By default, the entries are created from the field table
          * @return Data entry vector
          */
-        virtual std::vector<DataEntry> getData(Context context) const = 0;
+        virtual std::vector<DataEntry> getData(Context context) const;
+
+
+        /**
+         * Returns the static field table of the context. Storables providing a field table can be registered and
+         * enumerated without creating data entries
+         * @return Field table (empty by default)
+         */
+        virtual FieldTable getFields(Context /*context*/) const {
+
+            return {};
+
+        }
 
     };
 
@@ -84,6 +151,13 @@ namespace data {
             return os;
         }
         const void *v() const override { return value; }
+        DataType type() const override { return dataTypeOf<T>(); }
+        void json(std::string &out) const override {
+            if constexpr (isJsonValue<T>::value)
+                appendJson(out, *value, streamPrecision);
+            else
+                IDataSet::json(out);
+        }
     };
 
 
@@ -110,6 +184,55 @@ namespace data {
     }
 
 
+    /**
+     * Creates a field descriptor. Use the DATA_FIELD macro to create the descriptor of a structure member
+     * @tparam T Type of the field
+     * @param name Name of the field
+     * @param offset Offset of the field within the structure
+     * @return Field descriptor
+     */
+    template<typename T>
+    constexpr FieldDescriptor createFieldDescriptor(const char *name, std::size_t offset) {
+
+        static_assert(dataTypeOf<T>() != DataType::OTHER, "type of field is not supported");
+        return FieldDescriptor{name, offset, dataTypeOf<T>()};
+
+    }
+
+
+    /**
+     * Creates a field table from a static descriptor array and a structure instance
+     * @tparam N Number of fields
+     * @param fields Descriptor array
+     * @param base Structure instance
+     * @return Field table
+     */
+    template<std::size_t N>
+    inline FieldTable createFieldTable(const FieldDescriptor (&fields)[N], const void *base) {
+
+        return FieldTable{fields, N, base};
+
+    }
+
+
+    inline std::vector<IStorable::DataEntry> IStorable::getData(Context context) const {
+
+        auto table = getFields(context);
+
+        std::vector<DataEntry> ret;
+        ret.reserve(table.size);
+
+        for(std::size_t i = 0; i < table.size; ++i) {
+            visit(table.fields[i].type, table.pointer(i), [&ret, &table, i] (auto value) {
+                ret.emplace_back(createDataEntry(table.fields[i].name, value));
+            });
+        }
+
+        return ret;
+
+    }
+
+
 }} // namespace ::sim::data
 
 
@@ -0,0 +1,247 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_BINARYFORMAT_H
+#define SIMCORE_BINARYFORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "DataType.h"
+
+namespace sim {
+namespace data {
+
+
+    /**
+     * Supported binary formats
+     */
+    enum class BinaryFormat { CBOR, MSGPACK };
+
+
+    /**
+     * Appends an unsigned integer in big endian byte order to the given string
+     * @param out String to be appended
+     * @param value Value
+     * @param bytes Number of bytes to be written
+     */
+    inline void appendBigEndian(std::string &out, std::uint64_t value, unsigned int bytes) {
+
+        for(unsigned int i = bytes; i > 0; --i)
+            out.push_back(static_cast<char>((value >> (8u * (i - 1u))) & 0xffu));
+
+    }
+
+
+    /**
+     * Appends a CBOR head (major type and argument) to the given string
+     * @param out String to be appended
+     * @param major Major type
+     * @param value Argument
+     */
+    inline void appendCborHead(std::string &out, unsigned int major, std::uint64_t value) {
+
+        auto m = static_cast<char>(major << 5u);
+
+        if(value < 24) {
+            out.push_back(static_cast<char>(m | static_cast<char>(value)));
+        } else if(value <= 0xffu) {
+            out.push_back(static_cast<char>(m | 24));
+            appendBigEndian(out, value, 1);
+        } else if(value <= 0xffffu) {
+            out.push_back(static_cast<char>(m | 25));
+            appendBigEndian(out, value, 2);
+        } else if(value <= 0xffffffffu) {
+            out.push_back(static_cast<char>(m | 26));
+            appendBigEndian(out, value, 4);
+        } else {
+            out.push_back(static_cast<char>(m | 27));
+            appendBigEndian(out, value, 8);
+        }
+
+    }
+
+
+    /**
+     * Appends a MessagePack head with the smallest fitting size to the given string
+     * @param out String to be appended
+     * @param codes Type codes for 8, 16, 32 and 64 bit arguments (0 if not available)
+     * @param value Argument
+     */
+    inline void appendMsgpackHead(std::string &out, const unsigned char (&codes)[4], std::uint64_t value) {
+
+        if(value <= 0xffu && codes[0] != 0) {
+            out.push_back(static_cast<char>(codes[0]));
+            appendBigEndian(out, value, 1);
+        } else if(value <= 0xffffu) {
+            out.push_back(static_cast<char>(codes[1]));
+            appendBigEndian(out, value, 2);
+        } else if(value <= 0xffffffffu || codes[3] == 0) {
+            out.push_back(static_cast<char>(codes[2]));
+            appendBigEndian(out, value, 4);
+        } else {
+            out.push_back(static_cast<char>(codes[3]));
+            appendBigEndian(out, value, 8);
+        }
+
+    }
+
+
+    /**
+     * Appends the header of a map with the given number of entries
+     * @param out String to be appended
+     * @param format Binary format
+     * @param size Number of entries
+     */
+    inline void appendMapHeader(std::string &out, BinaryFormat format, std::size_t size) {
+
+        static const unsigned char codes[4] = {0, 0xde, 0xdf, 0};
+
+        if(format == BinaryFormat::CBOR)
+            appendCborHead(out, 5, size);
+        else if(size < 16)
+            out.push_back(static_cast<char>(0x80u | size));
+        else
+            appendMsgpackHead(out, codes, size);
+
+    }
+
+
+    /**
+     * Appends a text string
+     * @param out String to be appended
+     * @param format Binary format
+     * @param value Value
+     */
+    inline void appendBinary(std::string &out, BinaryFormat format, const std::string &value) {
+
+        static const unsigned char codes[4] = {0xd9, 0xda, 0xdb, 0};
+
+        if(format == BinaryFormat::CBOR)
+            appendCborHead(out, 3, value.size());
+        else if(value.size() < 32)
+            out.push_back(static_cast<char>(0xa0u | value.size()));
+        else
+            appendMsgpackHead(out, codes, value.size());
+
+        out.append(value);
+
+    }
+
+
+    /**
+     * Appends a boolean
+     * @param out String to be appended
+     * @param format Binary format
+     * @param value Value
+     */
+    inline void appendBinary(std::string &out, BinaryFormat format, bool value) {
+
+        if(format == BinaryFormat::CBOR)
+            out.push_back(static_cast<char>(value ? 0xf5 : 0xf4));
+        else
+            out.push_back(static_cast<char>(value ? 0xc3 : 0xc2));
+
+    }
+
+
+    /**
+     * Appends a number. Integers are written with the smallest fitting size, floating point values with their
+     * own precision
+     * @tparam T Type of the value
+     * @param out String to be appended
+     * @param format Binary format
+     * @param value Value
+     */
+    template<typename T>
+    inline typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type
+    appendBinary(std::string &out, BinaryFormat format, T value) {
+
+        static const unsigned char uintCodes[4] = {0xcc, 0xcd, 0xce, 0xcf};
+        static const unsigned char intCodes[4]  = {0xd0, 0xd1, 0xd2, 0xd3};
+
+        if constexpr (std::is_same<T, float>::value) {
+
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            out.push_back(static_cast<char>(format == BinaryFormat::CBOR ? 0xfa : 0xca));
+            appendBigEndian(out, bits, 4);
+
+        } else if constexpr (std::is_floating_point<T>::value) {
+
+            auto d = static_cast<double>(value);
+            std::uint64_t bits;
+            std::memcpy(&bits, &d, sizeof(bits));
+            out.push_back(static_cast<char>(format == BinaryFormat::CBOR ? 0xfb : 0xcb));
+            appendBigEndian(out, bits, 8);
+
+        } else if(value >= 0) {
+
+            auto v = static_cast<std::uint64_t>(value);
+
+            if(format == BinaryFormat::CBOR)
+                appendCborHead(out, 0, v);
+            else if(v < 128)
+                out.push_back(static_cast<char>(v));
+            else
+                appendMsgpackHead(out, uintCodes, v);
+
+        } else {
+
+            auto v = static_cast<std::int64_t>(value);
+
+            if(format == BinaryFormat::CBOR) {
+                appendCborHead(out, 1, static_cast<std::uint64_t>(-1 - v));
+            } else if(v >= -32) {
+                out.push_back(static_cast<char>(v));
+            } else {
+                // two's complement with the smallest fitting size
+                unsigned int bytes = v >= INT8_MIN ? 1 : v >= INT16_MIN ? 2 : v >= INT32_MIN ? 4 : 8;
+                out.push_back(static_cast<char>(intCodes[bytes == 1 ? 0 : bytes == 2 ? 1 : bytes == 4 ? 2 : 3]));
+                appendBigEndian(out, static_cast<std::uint64_t>(v), bytes);
+            }
+
+        }
+
+    }
+
+
+    /**
+     * Appends a typed value
+     * @param out String to be appended
+     * @param format Binary format
+     * @param type Data type of the value
+     * @param ptr Pointer to the value
+     * @return false, if the type is not supported
+     */
+    inline bool appendBinary(std::string &out, BinaryFormat format, DataType type, const void *ptr) {
+
+        return visit(type, ptr, [&out, format] (auto value) { appendBinary(out, format, *value); });
+
+    }
+
+
+}} // namespace ::sim::data
+
+
+#endif //SIMCORE_BINARYFORMAT_H
@@ -0,0 +1,253 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_BINARYREADER_H
+#define SIMCORE_BINARYREADER_H
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <nlohmann/json.hpp>
+#include "BinaryFormat.h"
+
+namespace sim {
+namespace data {
+
+
+    /**
+     * Reads a sequence of CBOR or MessagePack items as written by the BinaryReporter. The reader supports maps,
+     * arrays, strings, integers, floating point values, booleans and null
+     */
+    class BinaryReader {
+
+        std::istream *_is = nullptr;
+        BinaryFormat _format;
+
+
+    public:
+
+
+        /**
+         * Constructor
+         * @param is Stream to be read (should be opened in binary mode)
+         * @param format Binary format of the stream
+         */
+        BinaryReader(std::istream &is, BinaryFormat format) : _is(&is), _format(format) {}
+
+
+        /**
+         * Reads the next item
+         * @param item Item to be written
+         * @return false, if the end of the stream is reached
+         */
+        bool next(nlohmann::json &item) {
+
+            if(_is->peek() == std::char_traits<char>::eof())
+                return false;
+
+            item = _format == BinaryFormat::CBOR ? readCbor() : readMsgpack();
+            return true;
+
+        }
+
+
+    private:
+
+
+        std::uint8_t readByte() {
+
+            auto c = _is->get();
+            if(c == std::char_traits<char>::eof())
+                throw std::runtime_error("unexpected end of binary data");
+
+            return static_cast<std::uint8_t>(c);
+
+        }
+
+
+        std::uint64_t readBigEndian(unsigned int bytes) {
+
+            std::uint64_t v = 0;
+            for(unsigned int i = 0; i < bytes; ++i)
+                v = (v << 8u) | readByte();
+
+            return v;
+
+        }
+
+
+        std::string readString(std::uint64_t size) {
+
+            std::string str(size, '\0');
+            _is->read(&str[0], static_cast<std::streamsize>(size));
+            if(static_cast<std::uint64_t>(_is->gcount()) != size)
+                throw std::runtime_error("unexpected end of binary data");
+
+            return str;
+
+        }
+
+
+        double readFloat(unsigned int bytes) {
+
+            auto bits = readBigEndian(bytes);
+
+            if(bytes == 4) {
+                float f;
+                auto b = static_cast<std::uint32_t>(bits);
+                std::memcpy(&f, &b, sizeof(f));
+                return f;
+            }
+
+            double d;
+            std::memcpy(&d, &bits, sizeof(d));
+            return d;
+
+        }
+
+
+        nlohmann::json readCbor() {
+
+            auto head = readByte();
+            auto major = head >> 5u;
+            auto info = head & 0x1fu;
+
+            // simple values and floats
+            if(major == 7) {
+                switch(info) {
+                    case 20: return false;
+                    case 21: return true;
+                    case 22: return nullptr;
+                    case 26: return readFloat(4);
+                    case 27: return readFloat(8);
+                    default: throw std::runtime_error("unsupported CBOR item");
+                }
+            }
+
+            // argument
+            std::uint64_t arg;
+            if(info < 24)
+                arg = info;
+            else if(info <= 27)
+                arg = readBigEndian(1u << (info - 24u));
+            else
+                throw std::runtime_error("unsupported CBOR item");
+
+            switch(major) {
+                case 0: return arg;
+                case 1: return -1 - static_cast<std::int64_t>(arg);
+                case 3: return readString(arg);
+                case 4: {
+                    auto arr = nlohmann::json::array();
+                    for(std::uint64_t i = 0; i < arg; ++i)
+                        arr.push_back(readCbor());
+                    return arr;
+                }
+                case 5: {
+                    auto obj = nlohmann::json::object();
+                    for(std::uint64_t i = 0; i < arg; ++i) {
+                        auto key = readCbor();
+                        obj[key.get<std::string>()] = readCbor();
+                    }
+                    return obj;
+                }
+                default: throw std::runtime_error("unsupported CBOR item");
+            }
+
+        }
+
+
+        nlohmann::json readMsgpack() {
+
+            auto head = readByte();
+
+            // fixed size items
+            if(head <= 0x7f)
+                return head;
+            else if(head >= 0xe0)
+                return static_cast<std::int8_t>(head);
+            else if((head & 0xe0u) == 0xa0)
+                return readString(head & 0x1fu);
+            else if((head & 0xf0u) == 0x90)
+                return readMsgpackArray(head & 0x0fu);
+            else if((head & 0xf0u) == 0x80)
+                return readMsgpackMap(head & 0x0fu);
+
+            switch(head) {
+                case 0xc0: return nullptr;
+                case 0xc2: return false;
+                case 0xc3: return true;
+                case 0xca: return readFloat(4);
+                case 0xcb: return readFloat(8);
+                case 0xcc: return readBigEndian(1);
+                case 0xcd: return readBigEndian(2);
+                case 0xce: return readBigEndian(4);
+                case 0xcf: return readBigEndian(8);
+                case 0xd0: return static_cast<std::int8_t>(readBigEndian(1));
+                case 0xd1: return static_cast<std::int16_t>(readBigEndian(2));
+                case 0xd2: return static_cast<std::int32_t>(readBigEndian(4));
+                case 0xd3: return static_cast<std::int64_t>(readBigEndian(8));
+                case 0xd9: return readString(readBigEndian(1));
+                case 0xda: return readString(readBigEndian(2));
+                case 0xdb: return readString(readBigEndian(4));
+                case 0xdc: return readMsgpackArray(readBigEndian(2));
+                case 0xdd: return readMsgpackArray(readBigEndian(4));
+                case 0xde: return readMsgpackMap(readBigEndian(2));
+                case 0xdf: return readMsgpackMap(readBigEndian(4));
+                default: throw std::runtime_error("unsupported MessagePack item");
+            }
+
+        }
+
+
+        nlohmann::json readMsgpackArray(std::uint64_t size) {
+
+            auto arr = nlohmann::json::array();
+            for(std::uint64_t i = 0; i < size; ++i)
+                arr.push_back(readMsgpack());
+
+            return arr;
+
+        }
+
+
+        nlohmann::json readMsgpackMap(std::uint64_t size) {
+
+            auto obj = nlohmann::json::object();
+            for(std::uint64_t i = 0; i < size; ++i) {
+                auto key = readMsgpack();
+                obj[key.get<std::string>()] = readMsgpack();
+            }
+
+            return obj;
+
+        }
+
+    };
+
+
+}} // namespace ::sim::data
+
+
+#endif //SIMCORE_BINARYREADER_H
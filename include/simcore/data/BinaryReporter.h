@@ -0,0 +1,163 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_BINARYREPORTER_H
+#define SIMCORE_BINARYREPORTER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "../ISynchronized.h"
+#include "DataType.h"
+#include "BinaryFormat.h"
+
+
+/**
+ * Writes the same records as the JsonReporter ({"time":..., "key":..., ...}) as a sequence of CBOR or MessagePack
+ * maps, one map per synchronized step. The encoded keys are prepared once, each row is encoded directly into a
+ * buffer and written at once. The output can be read with the BinaryReader
+ */
+class BinaryReporter : public sim::ISynchronized {
+
+    struct Value {
+        sim::data::DataType type;
+        const void *ptr;
+    };
+
+    struct Field {
+        std::string key; // encoded key
+        Value value;
+    };
+
+    std::ostream *_outstream = nullptr;
+    sim::data::BinaryFormat _format = sim::data::BinaryFormat::CBOR;
+
+    std::map<std::string, Value> _values{};
+    std::vector<Field> _fields{};
+    std::string _prefix{}; // encoded map header and time key
+
+    std::string _buffer{};
+
+
+public:
+
+    /**
+     * Constructor
+     * @param format Binary format to be written
+     */
+    explicit BinaryReporter(sim::data::BinaryFormat format = sim::data::BinaryFormat::CBOR) : _format(format) {}
+
+
+    /**
+     * Adds a value to be logged
+     * @tparam T Type of the value
+     * @param key Key to be used in the records
+     * @param val Pointer to the value
+     */
+    template<typename T>
+    void addValue(const std::string &key, const T *val) {
+
+        static_assert(sim::data::dataTypeOf<T>() != sim::data::DataType::OTHER, "type is not supported");
+
+        if(key == "time")
+            throw std::invalid_argument("time key word is reserved.");
+
+        _values[key] = Value{sim::data::dataTypeOf<T>(), val};
+
+    }
+
+
+    /**
+     * Sets the stream in which the data shall be written (should be opened in binary mode)
+     * @param os Outstream
+     */
+    void setOutstream(std::ostream &os) {
+
+        _outstream = &os;
+
+    }
+
+
+protected:
+
+
+    bool step(double simTime) override {
+
+        // only step when its time
+        if(!sim::ISynchronized::step(simTime))
+            return false;
+
+        // encode record
+        _buffer = _prefix;
+        sim::data::appendBinary(_buffer, _format, simTime);
+
+        for(auto &f : _fields) {
+            _buffer.append(f.key);
+            sim::data::appendBinary(_buffer, _format, f.value.type, f.value.ptr);
+        }
+
+        // write record at once
+        _outstream->write(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+
+        return true;
+
+    }
+
+
+    void initialize(double initTime) override {
+
+        // init synchronized
+        sim::ISynchronized::initialize(initTime);
+
+        if(_outstream == nullptr)
+            throw std::runtime_error("Output stream is not initialized.");
+
+        // encode the constant parts
+        _prefix.clear();
+        sim::data::appendMapHeader(_prefix, _format, _values.size() + 1);
+        sim::data::appendBinary(_prefix, _format, std::string("time"));
+
+        _fields.clear();
+        for(auto &p : _values) {
+
+            std::string key;
+            sim::data::appendBinary(key, _format, p.first);
+
+            _fields.push_back(Field{std::move(key), p.second});
+
+        }
+
+    }
+
+
+    void terminate(double simTime) override {
+
+        _outstream->flush();
+
+    }
+
+
+};
+
+
+#endif //SIMCORE_BINARYREPORTER_H
@@ -25,13 +25,18 @@
 #ifndef SIMCORE_DATAMANAGER_H
 #define SIMCORE_DATAMANAGER_H
 
-#include <map>
-#include <list>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include <cassert>
 #include <iostream>
-#include <sstream>
-#include <nlohmann/json.hpp>
 #include "../functions.h"
 #include "../IStorable.h"
+#include "JsonFormat.h"
+#include "Registry.h"
+#include "RegistryBridge.h"
 
 namespace sim {
 namespace data {
@@ -39,20 +44,53 @@ namespace data {
 
 
     /**
-     * TODO: DataNode etc.
+     * The data manager organizes the data of registered storables in a tree (storable -> context -> value).
+     * The tree is stored as a flat node table: the children of a node are allocated as one contiguous block and
+     * referenced by an index range. Node names are interned, the values are indexed by their full name. Children
+     * of map nodes are kept in key order. Storables providing a field table are registered without creating data
+     * entries.
      */
     class DataManager {
 
-        struct DataNode {
+    public:
+
+        /**
+         * A pre-resolved reference to a value. Can be used to access the value without any lookup.
+         */
+        struct Handle {
+            std::size_t leaf = std::numeric_limits<std::size_t>::max();
+        };
 
-            std::shared_ptr<IDataSet> value;
-            std::list<DataNode> nodeArray{};
-            std::list<std::pair<std::string, DataNode>> nodeMap{};
 
+    private:
+
+        enum class NodeType { VALUE, MAP, ARRAY };
+
+        struct DataNode {
+            NodeType type = NodeType::MAP;
+            std::size_t name = 0;   // index of the interned name
+            std::size_t first = 0;  // index of the first child or index of the leaf value
+            std::size_t count = 0;  // number of children
+        };
+
+        std::vector<DataNode> _nodes{};
+        std::vector<std::size_t> _roots{};
+        struct Leaf {
+            const void *ptr = nullptr;
+            DataType type = DataType::OTHER;
+            std::shared_ptr<IDataSet> data{};   // only set for values registered by data entries
         };
 
-        DataNode _root{};
-        std::map<std::string, const DataNode*> _index{};
+        std::vector<Leaf> _leaves{};
+
+        std::vector<std::string> _names{};
+        std::unordered_map<std::string, std::size_t> _nameIndex{};
+
+        std::unordered_map<std::string, std::size_t> _index{};
+
+        mutable std::string _rowBuffer{};
+
+        int _precision = streamPrecision;
 
 
     public:
@@ -78,8 +116,9 @@ namespace data {
         void registerStorable(const std::string &name, const IStorable &store) {
 
             // create data node for storable class
-            _root.nodeMap.emplace_back(name, DataNode{});
-            auto dn = &_root.nodeMap.back().second;
+            auto dn = createNodes(1, NodeType::MAP);
+            _nodes[dn].name = intern(name);
+            addRoot(dn);
 
             // register parameters
             regStorable(name, &store, dn);
@@ -95,23 +134,35 @@ namespace data {
          */
         void registerStorableVector(const std::string &name, const std::vector<const IStorable *> &storage) {
 
-            // create node in root and get pointer
-            _root.nodeMap.emplace_back(name, DataNode{});
-            auto &dr = _root.nodeMap.back().second;
+            // create node in root
+            auto dr = createNodes(1, NodeType::ARRAY);
+            _nodes[dr].name = intern(name);
+            addRoot(dr);
 
-            // iterate over container
-            for(auto &store : storage) {
+            // create elements in array
+            auto first = createNodes(storage.size(), NodeType::MAP);
+            _nodes[dr].first = first;
+            _nodes[dr].count = storage.size();
 
-                // create element in array
-                dr.nodeArray.emplace_back(DataNode{});
-                auto dn = &dr.nodeArray.back();
+            // register storables
+            for(std::size_t i = 0; i < storage.size(); ++i)
+                regStorable(name, storage[i], first + i);
 
-                // register storable
-                regStorable(name, store, dn);
+        }
 
-            }
 
+        /**
+         * Resolves the name of a value to a handle, which can be used for repeated access
+         * @param name Name of the value
+         * @return Handle of the value
+         */
+        Handle resolve(const std::string &name) const {
+
+            auto it = _index.find(name);
+            if(it == _index.end())
+                throw std::invalid_argument(sim::fnc::string_format("No value \"%s\" defined", name.c_str()));
 
+            return Handle{it->second};
 
         }
 
@@ -123,10 +174,35 @@ namespace data {
          */
         const void* getValue(const std::string &name) const {
 
-            if(_index.find(name) == _index.end())
-                throw std::invalid_argument(sim::fnc::string_format("No value \"%s\" defined", name.c_str()));
+            return getValue(resolve(name));
+
+        }
+
+
+        /**
+         * Returns true if the handle refers to a registered value of this data manager. Default constructed handles
+         * are invalid
+         * @param handle Handle of the value
+         * @return Validity flag
+         */
+        bool isValid(const Handle &handle) const {
+
+            return handle.leaf < _leaves.size();
+
+        }
+
 
-            return _index.at(name)->value->v();
+        /**
+         * Returns the pointer to the value. The handle is not checked in release builds, it must be valid (see
+         * isValid)
+         * @param handle Handle of the value
+         * @return Pointer to the value
+         */
+        const void* getValue(const Handle &handle) const {
+
+            assert(isValid(handle));
+
+            return _leaves[handle.leaf].ptr;
 
         }
 
@@ -140,10 +216,37 @@ namespace data {
         template<typename T>
         const T& getValue(const std::string &name) const {
 
-            if(_index.find(name) == _index.end())
-                throw std::invalid_argument(sim::fnc::string_format("No value \"%s\" defined", name.c_str()));
+            return getValue<T>(resolve(name));
+
+        }
+
+
+        /**
+         * Returns a typed reference to the value. The handle is not checked in release builds, it must be valid (see
+         * isValid)
+         * @tparam T Type of the value
+         * @param handle Handle of the value
+         * @return Const reference to the value
+         */
+        template<typename T>
+        const T& getValue(const Handle &handle) const {
+
+            assert(isValid(handle));
+
+            return *static_cast<const T*>(_leaves[handle.leaf].ptr);
+
+        }
+
+
+        /**
+         * Sets the number of significant digits of floating point values. With zero, the values are written in the
+         * shortest representation, which is parsed back to the same value. The time of the rows written by
+         * streamValuesTo is always written in the shortest representation
+         * @param digits Number of significant digits (default: precision of std::ostream)
+         */
+        void setPrecision(int digits) {
 
-            return *static_cast<const T*>(_index.at(name)->value->v());
+            _precision = digits;
 
         }
 
@@ -159,98 +262,346 @@ namespace data {
 
 
         /**
-         * Streams the data manager to the given out stream
+         * Streams the data manager as JSON to the given out stream. The tree is written directly in one pass
          * @param os Out stream
          */
         std::ostream &streamTo(std::ostream &os) const {
 
-            os << nodeToJson(_root);
+            return writeTree(os, false);
+
+        }
+
+
+        /**
+         * Streams the structure of the data manager as JSON to the given out stream. Instead of the values, the
+         * leaves contain the index of the value in the rows written by streamValuesTo
+         * @param os Out stream
+         */
+        std::ostream &streamStructureTo(std::ostream &os) const {
+
+            return writeTree(os, true);
+
+        }
+
+
+        /**
+         * Streams the current values as JSON array to the given out stream. The first element of the array is the
+         * given time, the values follow in the order referenced by the structure written by streamStructureTo
+         * @param os Out stream
+         * @param time Time of the snapshot
+         */
+        std::ostream &streamValuesTo(std::ostream &os, double time) const {
+
+            _rowBuffer.clear();
+
+            _rowBuffer.push_back('[');
+            appendJson(_rowBuffer, time);
+
+            for(auto &leaf : _leaves) {
+                _rowBuffer.push_back(',');
+                writeLeaf(_rowBuffer, leaf, _precision);
+            }
+
+            _rowBuffer.push_back(']');
+
+            os.write(_rowBuffer.data(), static_cast<std::streamsize>(_rowBuffer.size()));
 
             return os;
 
         }
 
 
+        /**
+         * Publishes all values to the registry under their full name. The elements of storable vectors are published
+         * with their index (e.g. name.0.state.x). The registry refers to the values directly, so snapshots and
+         * recordings of the registry cover the registered storables
+         * @param registry Registry
+         * @return Number of published values
+         */
+        std::size_t publishTo(Registry &registry) const {
+
+            std::size_t count = 0;
+            for(auto r : _roots)
+                count += publishNode(registry, _names[_nodes[r].name], r);
+
+            return count;
+
+        }
+
+
+        /**
+         * Returns the number of registered values
+         * @return Number of values
+         */
+        std::size_t size() const {
+
+            return _leaves.size();
+
+        }
+
+
     private:
 
 
+        static constexpr std::size_t bufferSize = 1u << 16u;
+
+
+        /**
+         * Writes the tree as JSON to the given out stream
+         * @param os Out stream
+         * @param structure Flag to write the row index of the values instead of the values
+         */
+        std::ostream &writeTree(std::ostream &os, bool structure) const {
+
+            std::string buf;
+            buf.reserve(bufferSize);
+
+            buf.push_back('{');
+            for(std::size_t i = 0; i < _roots.size(); ++i) {
+
+                if(i != 0)
+                    buf.push_back(',');
+
+                appendJson(buf, _names[_nodes[_roots[i]].name]);
+                buf.push_back(':');
+                writeNode(os, buf, _roots[i], structure);
+
+            }
+            buf.push_back('}');
+
+            os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+
+            return os;
+
+        }
+
+
+        /**
+         * Adds a node to the root nodes (in key order)
+         * @param n Index of the node
+         */
+        void addRoot(std::size_t n) {
+
+            auto it = std::upper_bound(_roots.begin(), _roots.end(), n, [this] (std::size_t a, std::size_t b) {
+                return _names[_nodes[a].name] < _names[_nodes[b].name];
+            });
+
+            _roots.insert(it, n);
+
+        }
+
+
+        /**
+         * Interns the given string
+         * @param str String to be interned
+         * @return Index of the interned string
+         */
+        std::size_t intern(const std::string &str) {
+
+            auto it = _nameIndex.find(str);
+            if(it != _nameIndex.end())
+                return it->second;
+
+            _names.push_back(str);
+            _nameIndex.emplace(str, _names.size() - 1);
+
+            return _names.size() - 1;
+
+        }
+
+
+        /**
+         * Creates a contiguous block of nodes
+         * @param count Number of nodes
+         * @param type Type of the nodes
+         * @return Index of the first node
+         */
+        std::size_t createNodes(std::size_t count, NodeType type) {
+
+            auto first = _nodes.size();
+            _nodes.resize(first + count, DataNode{type});
+
+            return first;
+
+        }
+
+
         /**
          * Registers a storable container to the given data node
          * @param name Name of the container
          * @param store Container
          * @param dn Data node to be written to
          */
-        void regStorable(const std::string &name, const IStorable *store, DataNode *dn) {
+        void regStorable(const std::string &name, const IStorable *store, std::size_t dn) {
 
-            // register parameters
-            dn->nodeMap.emplace_back("parameter", DataNode{nullptr});
-            auto vals = store->getData(IStorable::PARAMETER);
-            for (auto &v : vals)
-                regValue(dn->nodeMap.back().second, name, "parameter", v);
-
-            // register inputs
-            dn->nodeMap.emplace_back("input", DataNode{nullptr});
-            vals = store->getData(IStorable::INPUT);
-            for (auto &v : vals)
-                regValue(dn->nodeMap.back().second, name, "input", v);
-
-            // register states
-            dn->nodeMap.emplace_back("state", DataNode{nullptr});
-            vals = store->getData(IStorable::STATE);
-            for (auto &v : vals)
-                regValue(dn->nodeMap.back().second, name, "state", v);
+            static const IStorable::Context contexts[] = {IStorable::INPUT, IStorable::PARAMETER, IStorable::STATE};
+
+            // create context nodes
+            auto first = createNodes(3, NodeType::MAP);
+            _nodes[dn].first = first;
+            _nodes[dn].count = 3;
+
+            // register parameters, inputs and states
+            for(std::size_t c = 0; c < 3; ++c) {
+
+                auto context = IStorable::contextName(contexts[c]);
+                _nodes[first + c].name = intern(context);
+
+                std::vector<std::pair<std::string, Leaf>> values;
+
+                // take the field table if available, otherwise the data entries
+                auto table = store->getFields(contexts[c]);
+                if(table.size != 0) {
+
+                    values.reserve(table.size);
+                    for(std::size_t i = 0; i < table.size; ++i)
+                        values.emplace_back(table.fields[i].name, Leaf{table.pointer(i), table.fields[i].type});
+
+                } else {
+
+                    auto entries = store->getData(contexts[c]);
+                    values.reserve(entries.size());
+                    for(auto &e : entries)
+                        values.emplace_back(e.name, Leaf{e.data->v(), e.data->type(), e.data});
+
+                }
+
+                regValues(name, context, std::move(values), first + c);
+
+            }
 
         }
 
 
         /**
-         * Registers a value to the data manager
-         * @param dn The data node, the value shall be stored in
+         * Registers the values to the data manager
          * @param name Name of the owner object
-         * @param context Context of the value
-         * @param value Value object
+         * @param context Context of the values
+         * @param values Named values
+         * @param dn The data node, the values shall be stored in
+         */
+        void regValues(const std::string &name, const std::string &context,
+                std::vector<std::pair<std::string, Leaf>> &&values, std::size_t dn) {
+
+            // sort values by name
+            std::stable_sort(values.begin(), values.end(), [] (const std::pair<std::string, Leaf> &a,
+                    const std::pair<std::string, Leaf> &b) {
+                return a.first < b.first;
+            });
+
+            // create value nodes
+            auto first = createNodes(values.size(), NodeType::VALUE);
+            _nodes[dn].first = first;
+            _nodes[dn].count = values.size();
+
+            // key prefix of the values
+            auto prefix = name + "." + context + ".";
+
+            for(std::size_t i = 0; i < values.size(); ++i) {
+
+                // add leaf
+                auto &node = _nodes[first + i];
+                node.name = intern(values[i].first);
+                node.first = _leaves.size();
+                _leaves.push_back(std::move(values[i].second));
+
+                // save to index
+                _index[prefix + values[i].first] = node.first;
+
+            }
+
+        }
+
+
+        /**
+         * Recursive function to publish the values of a data node to the registry
+         * @param registry Registry
+         * @param key Full name of the data node
+         * @param n Index of the data node
+         * @return Number of published values
          */
-        void regValue(DataNode &dn, const std::string &name, const std::string &context, const IStorable::DataEntry &v) {
+        std::size_t publishNode(Registry &registry, const std::string &key, std::size_t n) const {
+
+            auto &node = _nodes[n];
+
+            if(node.type == NodeType::VALUE)
+                return publishValue(registry, key, _leaves[node.first].type, _leaves[node.first].ptr);
+
+            std::size_t count = 0;
+            for(auto i = node.first; i < node.first + node.count; ++i) {
+
+                // array elements are named by their index
+                auto child = node.type == NodeType::ARRAY ? std::to_string(i - node.first) : _names[_nodes[i].name];
+                count += publishNode(registry, key + "." + child, i);
+
+            }
+
+            return count;
+
+        }
 
-            // add to root
-            dn.nodeMap.emplace_back(v.name, DataNode{v.data});
 
-            // save to index
-            _index[sim::fnc::string_format("%s.%s.%s", name.c_str(), context.c_str(), v.name.c_str())]
-                = &dn.nodeMap.back().second;
+        /**
+         * Writes the value of the leaf as JSON to the buffer
+         * @param buf Buffer
+         * @param leaf Leaf
+         * @param precision Number of significant digits
+         */
+        static void writeLeaf(std::string &buf, const Leaf &leaf, int precision) {
+
+            if(!appendJson(buf, leaf.type, leaf.ptr, precision))
+                leaf.data->json(buf);
 
         }
 
 
         /**
-         * Recursive function to create a json object from a data node
-         * @param node Data node
-         * @return JSON object
+         * Recursive function to write a data node as JSON to the buffer. The buffer is flushed to the stream, when
+         * its size exceeds the buffer size
+         * @param os Out stream
+         * @param buf Buffer
+         * @param n Index of the data node
+         * @param structure Flag to write the row index of the values instead of the values
          */
-        static nlohmann::json nodeToJson(const DataNode &node) {
+        void writeNode(std::ostream &os, std::string &buf, std::size_t n, bool structure) const {
+
+            auto &node = _nodes[n];
 
-            if(node.value) { // value (leaf)
+            if(node.type == NodeType::VALUE) { // value (leaf)
 
-                // serialize leaf via existing ostream interface
-                std::ostringstream os;
-                node.value->s(os);
-                // parse back to get proper JSON type (number vs string)
-                return nlohmann::json::parse(os.str());
+                if(structure)
+                    appendJson(buf, node.first + 1);
+                else
+                    writeLeaf(buf, _leaves[node.first], _precision);
 
-            } else if(!node.nodeMap.empty()) { // map
+            } else if(node.type == NodeType::MAP) { // map
 
-                nlohmann::json obj = nlohmann::json::object();
-                for(auto &p : node.nodeMap)
-                    obj[p.first] = nodeToJson(p.second);
-                return obj;
+                buf.push_back('{');
+                for(auto i = node.first; i < node.first + node.count; ++i) {
+                    if(i != node.first)
+                        buf.push_back(',');
+                    appendJson(buf, _names[_nodes[i].name]);
+                    buf.push_back(':');
+                    writeNode(os, buf, i, structure);
+                }
+                buf.push_back('}');
 
             } else { // array
 
-                nlohmann::json arr = nlohmann::json::array();
-                for(auto &p : node.nodeArray)
-                    arr.push_back(nodeToJson(p));
-                return arr;
+                buf.push_back('[');
+                for(auto i = node.first; i < node.first + node.count; ++i) {
+                    if(i != node.first)
+                        buf.push_back(',');
+                    writeNode(os, buf, i, structure);
+                }
+                buf.push_back(']');
+
+            }
 
+            // flush buffer
+            if(buf.size() >= bufferSize) {
+                os.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+                buf.clear();
             }
 
         }
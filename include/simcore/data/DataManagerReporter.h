@@ -0,0 +1,134 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_DATAMANAGERREPORTER_H
+#define SIMCORE_DATAMANAGERREPORTER_H
+
+#include <iostream>
+#include "../ISynchronized.h"
+#include "DataManager.h"
+
+
+/**
+ * Streams the content of a data manager as time series. The structure of the data manager is written once, each
+ * synchronized step appends a row with the time and the values:
+ *
+ *   {"structure":{"Model":{"input":{"a":1},...}},"rows":[
+ *   [0,1.5,...],
+ *   ...
+ *   ]}
+ *
+ * The leaves of the structure hold the index of the value within the rows, index 0 is the time.
+ */
+class DataManagerReporter : public sim::ISynchronized {
+
+    const sim::data::DataManager *_data = nullptr;
+    std::ostream *_outstream = nullptr;
+
+    bool _hasContent = false;
+
+
+public:
+
+    /**
+     * Constructor
+     */
+    DataManagerReporter() = default;
+
+
+    /**
+     * Sets the data manager to be reported
+     * @param data Data manager
+     */
+    void setDataManager(const sim::data::DataManager &data) {
+
+        _data = &data;
+
+    }
+
+
+    /**
+     * Sets the stream in which the data shall be written
+     * @param os Outstream
+     */
+    void setOutstream(std::ostream &os) {
+
+        _outstream = &os;
+
+    }
+
+
+protected:
+
+
+    bool step(double simTime) override {
+
+        // only step when its time
+        if(!sim::ISynchronized::step(simTime))
+            return false;
+
+        // write row
+        (*_outstream) << (_hasContent ? ",\n" : "\n");
+        _data->streamValuesTo(*_outstream, simTime);
+
+        // save that data was already written
+        _hasContent = true;
+
+        // success
+        return true;
+
+    }
+
+
+    void initialize(double initTime) override {
+
+        // init synchronized
+        sim::ISynchronized::initialize(initTime);
+
+        if(_outstream == nullptr)
+            throw std::runtime_error("Output stream is not initialized.");
+
+        if(_data == nullptr)
+            throw std::runtime_error("Data manager is not set.");
+
+        // write structure
+        (*_outstream) << R"({"structure":)";
+        _data->streamStructureTo(*_outstream);
+        (*_outstream) << R"(,"rows":[)";
+
+        _hasContent = false;
+
+    }
+
+
+    void terminate(double simTime) override {
+
+        // close brackets
+        (*_outstream) << "\n]}" << std::endl;
+
+    }
+
+
+};
+
+
+#endif //SIMCORE_DATAMANAGERREPORTER_H
@@ -0,0 +1,154 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_DATATYPE_H
+#define SIMCORE_DATATYPE_H
+
+#include <string>
+#include <type_traits>
+#include <typeindex>
+
+namespace sim {
+namespace data {
+
+
+    /**
+     * Value types which can be handled without type-specific code
+     */
+    enum class DataType { OTHER, BOOL, INT, UINT, LONG, ULONG, LLONG, ULLONG, FLOAT, DOUBLE, STRING };
+
+
+    /**
+     * Returns the data type of the given type
+     * @tparam T Type
+     * @return Data type (OTHER, if the type is not supported)
+     */
+    template<typename T>
+    constexpr DataType dataTypeOf() {
+
+        using U = typename std::remove_cv<T>::type;
+
+        if constexpr (std::is_same<U, bool>::value)
+            return DataType::BOOL;
+        else if constexpr (std::is_same<U, int>::value)
+            return DataType::INT;
+        else if constexpr (std::is_same<U, unsigned int>::value)
+            return DataType::UINT;
+        else if constexpr (std::is_same<U, long>::value)
+            return DataType::LONG;
+        else if constexpr (std::is_same<U, unsigned long>::value)
+            return DataType::ULONG;
+        else if constexpr (std::is_same<U, long long>::value)
+            return DataType::LLONG;
+        else if constexpr (std::is_same<U, unsigned long long>::value)
+            return DataType::ULLONG;
+        else if constexpr (std::is_same<U, float>::value)
+            return DataType::FLOAT;
+        else if constexpr (std::is_same<U, double>::value)
+            return DataType::DOUBLE;
+        else if constexpr (std::is_same<U, std::string>::value)
+            return DataType::STRING;
+        else
+            return DataType::OTHER;
+
+    }
+
+
+    /**
+     * Returns the data type of the given runtime type
+     * @param type Type index
+     * @return Data type (OTHER, if the type is not supported)
+     */
+    inline DataType dataTypeOf(const std::type_index &type) {
+
+        if(type == typeid(bool))               return DataType::BOOL;
+        if(type == typeid(int))                return DataType::INT;
+        if(type == typeid(unsigned int))       return DataType::UINT;
+        if(type == typeid(long))               return DataType::LONG;
+        if(type == typeid(unsigned long))      return DataType::ULONG;
+        if(type == typeid(long long))          return DataType::LLONG;
+        if(type == typeid(unsigned long long)) return DataType::ULLONG;
+        if(type == typeid(float))              return DataType::FLOAT;
+        if(type == typeid(double))             return DataType::DOUBLE;
+        if(type == typeid(std::string))        return DataType::STRING;
+
+        return DataType::OTHER;
+
+    }
+
+
+    /**
+     * Calls the given function with a typed pointer to the value
+     * @tparam F Function type
+     * @param type Data type of the value
+     * @param ptr Pointer to the value
+     * @param f Function to be called with the typed pointer
+     * @return false, if the type is not supported
+     */
+    template<typename F>
+    inline bool visit(DataType type, const void *ptr, F &&f) {
+
+        switch(type) {
+            case DataType::BOOL:   f(static_cast<const bool*>(ptr)); return true;
+            case DataType::INT:    f(static_cast<const int*>(ptr)); return true;
+            case DataType::UINT:   f(static_cast<const unsigned int*>(ptr)); return true;
+            case DataType::LONG:   f(static_cast<const long*>(ptr)); return true;
+            case DataType::ULONG:  f(static_cast<const unsigned long*>(ptr)); return true;
+            case DataType::LLONG:  f(static_cast<const long long*>(ptr)); return true;
+            case DataType::ULLONG: f(static_cast<const unsigned long long*>(ptr)); return true;
+            case DataType::FLOAT:  f(static_cast<const float*>(ptr)); return true;
+            case DataType::DOUBLE: f(static_cast<const double*>(ptr)); return true;
+            case DataType::STRING: f(static_cast<const std::string*>(ptr)); return true;
+            default: return false;
+        }
+
+    }
+
+
+    /**
+     * Converts a numeric value to double
+     * @param type Data type of the value
+     * @param ptr Pointer to the value
+     * @param out Converted value
+     * @return false, if the type is not numeric
+     */
+    inline bool toDouble(DataType type, const void *ptr, double &out) {
+
+        auto numeric = false;
+
+        visit(type, ptr, [&out, &numeric] (auto value) {
+            using T = typename std::remove_const<typename std::remove_pointer<decltype(value)>::type>::type;
+            if constexpr (std::is_arithmetic<T>::value) {
+                out = static_cast<double>(*value);
+                numeric = true;
+            }
+        });
+
+        return numeric;
+
+    }
+
+
+}} // namespace ::sim::data
+
+
+#endif //SIMCORE_DATATYPE_H
@@ -0,0 +1,329 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_DOWNSAMPLER_H
+#define SIMCORE_DOWNSAMPLER_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+namespace sim {
+namespace data {
+
+
+    /**
+     * Downsampling modes
+     */
+    enum class Downsampling {
+        NONE,   //!< all samples are kept
+        MINMAX, //!< minimum and maximum of each bucket are kept
+        LTTB    //!< largest-triangle-three-buckets decimation
+    };
+
+
+    /**
+     * An online downsampler for a single x-y trace. The memory is bounded by the maximum number of points, independent
+     * of the number of added samples.
+     *
+     * MINMAX collects the samples in buckets of equal sample count and keeps the minimum and maximum sample of each
+     * bucket, so peaks are always preserved. When all buckets are filled, neighbouring buckets are merged pairwise and
+     * the bucket width is doubled. The last sample is kept in addition.
+     *
+     * LTTB uses the same fixed buckets, merged in the same way, and additionally sums up the samples of each bucket.
+     * The result contains the first and the last sample and one point per bucket, selected from the minimum and maximum
+     * of the bucket by largest-triangle-three-buckets. Each bucket represents the same number of samples, so the
+     * points are spread evenly over the trace and peaks are preserved as candidates of their bucket.
+     */
+    class Downsampler {
+
+        struct Point {
+            std::size_t index;
+            double x;
+            double y;
+        };
+
+        struct Bucket {
+            Point min;
+            Point max;
+            std::size_t count;
+            double sumX;
+            double sumY;
+        };
+
+        Downsampling _mode = Downsampling::NONE;
+        std::size_t _maxPoints = 0;
+        std::size_t _samples = 0;
+
+        // min/max and lttb
+        std::vector<Bucket> _buckets{};
+        std::size_t _width = 1;
+        Point _first{};
+        Point _last{};
+
+        // no downsampling
+        std::vector<Point> _points{};
+
+
+    public:
+
+
+        /**
+         * Constructor
+         * @param mode Downsampling mode
+         * @param maxPoints Maximum number of points in the result (at least four)
+         */
+        Downsampler(Downsampling mode, std::size_t maxPoints) : _mode(mode), _maxPoints(maxPoints) {
+
+            if(maxPoints < 4)
+                throw std::invalid_argument("maximum number of points must be at least four.");
+
+            if(_mode == Downsampling::NONE)
+                _points.reserve(maxPoints);
+            else
+                _buckets.reserve(buckets());
+
+        }
+
+
+        /**
+         * Adds a sample
+         * @param x x value
+         * @param y y value
+         */
+        void add(double x, double y) {
+
+            Point p{_samples++, x, y};
+
+            if(_mode == Downsampling::NONE) {
+                _points.push_back(p);
+                return;
+            }
+
+            if(p.index == 0)
+                _first = p;
+
+            addToBucket(p);
+            _last = p;
+
+        }
+
+
+        /**
+         * Returns the number of added samples
+         * @return Number of samples
+         */
+        std::size_t samples() const {
+
+            return _samples;
+
+        }
+
+
+        /**
+         * Writes the downsampled trace in sample order. The number of points does not exceed the maximum number of
+         * points
+         * @param x x values
+         * @param y y values
+         */
+        void result(std::vector<double> &x, std::vector<double> &y) {
+
+            x.clear();
+            y.clear();
+
+            if(_mode == Downsampling::MINMAX) {
+
+                for(auto &b : _buckets) {
+
+                    auto &first = b.min.index < b.max.index ? b.min : b.max;
+                    auto &second = b.min.index < b.max.index ? b.max : b.min;
+
+                    x.push_back(first.x);
+                    y.push_back(first.y);
+
+                    if(first.index == second.index)
+                        continue;
+
+                    x.push_back(second.x);
+                    y.push_back(second.y);
+
+                }
+
+                // add last sample
+                if(_samples > 0 && std::max(_buckets.back().min.index, _buckets.back().max.index) != _last.index) {
+                    x.push_back(_last.x);
+                    y.push_back(_last.y);
+                }
+
+                return;
+
+            }
+
+            if(_mode == Downsampling::LTTB) {
+                selectLttb(x, y);
+                return;
+            }
+
+            for(auto &p : _points) {
+                x.push_back(p.x);
+                y.push_back(p.y);
+            }
+
+        }
+
+
+    private:
+
+
+        std::size_t buckets() const {
+
+            // min/max: two points per bucket and the last sample, lttb: one point per bucket, the first and the last
+            return _mode == Downsampling::MINMAX ? (_maxPoints - 1) / 2 : _maxPoints - 2;
+
+        }
+
+
+        void addToBucket(const Point &p) {
+
+            // add to current bucket
+            if(!_buckets.empty() && _buckets.back().count < _width) {
+
+                auto &b = _buckets.back();
+
+                if(p.y < b.min.y)
+                    b.min = p;
+
+                if(p.y > b.max.y)
+                    b.max = p;
+
+                b.count++;
+                b.sumX += p.x;
+                b.sumY += p.y;
+                return;
+
+            }
+
+            // merge buckets pairwise, when all buckets are filled
+            if(_buckets.size() == buckets()) {
+
+                std::size_t n = 0;
+                for(std::size_t i = 0; i < _buckets.size(); i += 2, ++n) {
+
+                    auto b = _buckets[i];
+
+                    if(i + 1 < _buckets.size()) {
+
+                        auto &o = _buckets[i + 1];
+
+                        if(o.min.y < b.min.y)
+                            b.min = o.min;
+
+                        if(o.max.y > b.max.y)
+                            b.max = o.max;
+
+                        b.count += o.count;
+                        b.sumX += o.sumX;
+                        b.sumY += o.sumY;
+
+                    }
+
+                    _buckets[n] = b;
+
+                }
+
+                _buckets.resize(n);
+                _width *= 2;
+
+                // the last bucket can take the sample, if it is not full
+                if(_buckets.back().count < _width) {
+                    addToBucket(p);
+                    return;
+                }
+
+            }
+
+            _buckets.push_back({p, p, 1, p.x, p.y});
+
+        }
+
+
+        void selectLttb(std::vector<double> &x, std::vector<double> &y) const {
+
+            if(_samples == 0)
+                return;
+
+            // the first sample is kept
+            auto a = _first;
+            x.push_back(a.x);
+            y.push_back(a.y);
+
+            for(std::size_t i = 0; i < _buckets.size(); ++i) {
+
+                auto &b = _buckets[i];
+
+                // average of the next bucket or the last sample
+                double avgX = _last.x, avgY = _last.y;
+                if(i + 1 < _buckets.size()) {
+                    auto &n = _buckets[i + 1];
+                    avgX = n.sumX / static_cast<double>(n.count);
+                    avgY = n.sumY / static_cast<double>(n.count);
+                }
+
+                // select the candidate with the largest triangle
+                const Point *next = &b.min;
+                double maxArea = -1.0;
+                for(auto c : {&b.min, &b.max}) {
+
+                    auto area = std::fabs((a.x - avgX) * (c->y - a.y) - (a.x - c->x) * (avgY - a.y));
+
+                    if(area > maxArea) {
+                        maxArea = area;
+                        next = c;
+                    }
+
+                }
+
+                // the first and the last sample are written anyway
+                if(next->index != a.index && next->index != _last.index) {
+                    x.push_back(next->x);
+                    y.push_back(next->y);
+                }
+
+                a = *next;
+
+            }
+
+            // the last sample is kept
+            if(_last.index != _first.index) {
+                x.push_back(_last.x);
+                y.push_back(_last.y);
+            }
+
+        }
+
+    };
+
+}} // namespace sim::data
+
+#endif // SIMCORE_DOWNSAMPLER_H
@@ -25,20 +25,47 @@
 #define SIMCORE_JSONFILEREPORTER_H
 
 #include "JsonReporter.h"
+#include "RowRing.h"
 #include <fstream>
+#include <thread>
+#include <atomic>
+#include <chrono>
 
 
 class JsonFileReporter : public JsonReporter {
 
+public:
+
+    /**
+     * Behavior of the asynchronous mode when the row buffer is full
+     */
+    enum class Overflow { BLOCK, DROP };
+
+
+private:
 
     std::fstream _fstream;
     std::string _filename;
 
+    bool _async = false;
+    std::size_t _capacity = 0;
+    Overflow _overflow = Overflow::BLOCK;
+
+    sim::data::RowRing _ring{};
+    std::thread _writer{};
+    std::atomic<bool> _running{false};
+    std::size_t _dropped = 0;
+
+
 public:
 
     JsonFileReporter() = default;
 
-    ~JsonFileReporter() override = default;
+    ~JsonFileReporter() override {
+
+        stopWriter();
+
+    }
 
 
     void setFilename(const std::string &name) {
@@ -48,22 +75,102 @@ public:
     }
 
 
+    /**
+     * Activates the asynchronous mode. The values are copied into a preallocated row buffer in each step, a
+     * background thread formats the rows and writes the file. Only scalar values are supported in this mode
+     * @param capacity Number of rows the buffer can hold
+     * @param overflow Behavior when the buffer is full: wait for the writer (BLOCK) or drop the row (DROP)
+     */
+    void setAsync(std::size_t capacity, Overflow overflow = Overflow::BLOCK) {
+
+        if(capacity == 0)
+            throw std::invalid_argument("capacity must be greater than zero.");
+
+        _async = true;
+        _capacity = capacity;
+        _overflow = overflow;
+
+    }
+
+
+    /**
+     * Returns the number of rows dropped in the asynchronous mode
+     * @return Number of dropped rows
+     */
+    std::size_t dropped() const {
+
+        return _dropped;
+
+    }
+
+
 protected:
 
 
 
     void initialize(double initTime) override {
 
+        stopWriter();
+
         _fstream.open(_filename, std::ios::out);
         setOutstream(_fstream);
 
         JsonReporter::initialize(initTime);
 
+        if(!_async)
+            return;
+
+        // allocate buffer (time + values) and check values
+        _ring.resize(_capacity, numberOfValues() + 1);
+        auto row = _ring.acquire();
+        if(!snapshot(row + 1))
+            throw std::runtime_error("Asynchronous mode only supports scalar values.");
+
+        // start writer
+        _dropped = 0;
+        _running = true;
+        _writer = std::thread(&JsonFileReporter::write, this);
+
+    }
+
+
+    bool step(double simTime) override {
+
+        if(!_async)
+            return JsonReporter::step(simTime);
+
+        // only step when its time
+        if(!sim::ISynchronized::step(simTime))
+            return false;
+
+        // get free row
+        auto row = _ring.acquire();
+        while(row == nullptr) {
+
+            if(_overflow == Overflow::DROP) {
+                _dropped++;
+                return true;
+            }
+
+            std::this_thread::yield();
+            row = _ring.acquire();
+
+        }
+
+        // copy time and values
+        std::memcpy(row[0].bytes, &simTime, sizeof(double));
+        snapshot(row + 1);
+        _ring.commit();
+
+        return true;
+
     }
 
 
     void terminate(double simTime) override {
 
+        stopWriter();
+
         JsonReporter::terminate(simTime);
 
         _fstream.close();
@@ -71,6 +178,55 @@ protected:
     }
 
 
+private:
+
+
+    /**
+     * Writer thread: formats and writes the buffered rows until the writer is stopped and the buffer is empty
+     */
+    void write() {
+
+        while(true) {
+
+            // check running flag before the buffer, so no row is lost
+            auto running = _running.load();
+
+            auto row = _ring.front();
+            if(row != nullptr) {
+
+                double time;
+                std::memcpy(&time, row[0].bytes, sizeof(double));
+                writeRow(time, row + 1);
+                _ring.pop();
+
+            } else if(!running) {
+
+                break;
+
+            } else {
+
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+            }
+
+        }
+
+    }
+
+
+    /**
+     * Stops the writer thread after all buffered rows are written
+     */
+    void stopWriter() {
+
+        _running = false;
+
+        if(_writer.joinable())
+            _writer.join();
+
+    }
+
+
 };
 
 
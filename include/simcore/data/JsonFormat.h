@@ -0,0 +1,157 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_JSONFORMAT_H
+#define SIMCORE_JSONFORMAT_H
+
+#include <charconv>
+#include <cmath>
+#include <string>
+#include <type_traits>
+#include "DataType.h"
+
+namespace sim {
+namespace data {
+
+
+    /**
+     * Trait to check if a type can be written as a JSON value directly
+     * @tparam T Type to be checked
+     */
+    template<typename T>
+    struct isJsonValue : std::integral_constant<bool, std::is_arithmetic<T>::value
+            || std::is_same<T, std::string>::value> {};
+
+
+    /**
+     * Appends a boolean as JSON value to the given string
+     * @param out String to be appended
+     * @param value Value
+     */
+    inline void appendJson(std::string &out, bool value, int = 0) {
+
+        out.append(value ? "true" : "false");
+
+    }
+
+
+    /**
+     * Precision of floating point values written by a default std::ostream
+     */
+    constexpr int streamPrecision = 6;
+
+
+    /**
+     * Appends a number as JSON value to the given string. Floating point values are written with the given number
+     * of significant digits or, if the precision is zero, in the shortest representation which is parsed back to
+     * the same value. Non-finite values are written as null
+     * @tparam T Type of the value
+     * @param out String to be appended
+     * @param value Value
+     * @param precision Number of significant digits (floating point values only)
+     */
+    template<typename T>
+    inline typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type
+    appendJson(std::string &out, T value, int precision = 0) {
+
+        char buf[32];
+        std::to_chars_result res{};
+
+        if constexpr (std::is_floating_point<T>::value) {
+
+            if(!std::isfinite(value)) {
+                out.append("null");
+                return;
+            }
+
+            if(precision > 0)
+                res = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::general, precision);
+            else
+                res = std::to_chars(buf, buf + sizeof(buf), value);
+
+        } else {
+
+            res = std::to_chars(buf, buf + sizeof(buf), value);
+
+        }
+
+        out.append(buf, res.ptr);
+
+    }
+
+
+    /**
+     * Appends a string as quoted and escaped JSON string to the given string
+     * @param out String to be appended
+     * @param value Value
+     */
+    inline void appendJson(std::string &out, const std::string &value, int = 0) {
+
+        static const char *hex = "0123456789abcdef";
+
+        out.push_back('"');
+
+        for(unsigned char c : value) {
+
+            switch(c) {
+                case '"':  out.append("\\\""); break;
+                case '\\': out.append("\\\\"); break;
+                case '\b': out.append("\\b");  break;
+                case '\f': out.append("\\f");  break;
+                case '\n': out.append("\\n");  break;
+                case '\r': out.append("\\r");  break;
+                case '\t': out.append("\\t");  break;
+                default:
+                    if(c < 0x20) {
+                        out.append("\\u00");
+                        out.push_back(hex[c >> 4u]);
+                        out.push_back(hex[c & 0xfu]);
+                    } else
+                        out.push_back(static_cast<char>(c));
+            }
+
+        }
+
+        out.push_back('"');
+
+    }
+
+
+    /**
+     * Appends a typed value as JSON value to the given string
+     * @param out String to be appended
+     * @param type Data type of the value
+     * @param ptr Pointer to the value
+     * @param precision Number of significant digits (floating point values only)
+     * @return false, if the type is not supported
+     */
+    inline bool appendJson(std::string &out, DataType type, const void *ptr, int precision = 0) {
+
+        return visit(type, ptr, [&out, precision] (auto value) { appendJson(out, *value, precision); });
+
+    }
+
+
+}} // namespace ::sim::data
+
+
+#endif //SIMCORE_JSONFORMAT_H
@@ -27,20 +27,75 @@
 
 #include <map>
 #include <string>
+#include <algorithm>
+#include <iterator>
+#include <vector>
 #include <cmath>
 #include <iostream>
 #include <memory>
+#include <cstring>
+#include <type_traits>
 #include "../ISynchronized.h"
 #include "../IStorable.h"
 #include "../exceptions.h"
+#include "DataType.h"
+#include "JsonFormat.h"
+#include "RowRing.h"
+
+
+/**
+ * Writes the values of each synchronized step as JSON.
+ *
+ * Values with a deadband (see setDeadband) are only written when they moved beyond the deadband since they were
+ * written last. In the OBJECTS format, the unchanged values are omitted, in the ROWS format the complete row is
+ * written. A row is skipped completely, if none of the values with a deadband changed. Values without deadband
+ * are written with every row, which is written. The first row, the keep-alive rows (see setKeepAlive) and a final
+ * row for the last skipped step are written completely. A value at time t can therefore be reconstructed by the
+ * last value written for its key at or before t with an error not greater than its deadband.
+ */
+class JsonReporter : public sim::ISynchronized {
 
+public:
 
-class JsonReporter : public sim::ISynchronized {
+    /**
+     * Output formats: an array of objects with keys ([{"time":0,"a":1},...]) or a key list written once and an
+     * array of value rows in key order ({"keys":["time","a"],"rows":[[0,1],...]})
+     */
+    enum class Format { OBJECTS, ROWS };
+
+
+private:
+
+    struct Value {
+        sim::data::DataType type = sim::data::DataType::OTHER;
+        const void *ptr = nullptr;
+        std::shared_ptr<sim::data::IDataSet> data{}; // only set for types without direct formatting
+    };
+
+    struct Field {
+        std::string fragment; // constant JSON text in front of the value (,"key": or ,)
+        Value value;
+        double deadband = -1.0; // negative: no deadband
+        double last = 0.0;      // last written value
+        double current = 0.0;   // value of the row in progress
+        bool changed = false;
+    };
 
     std::ostream *_outstream = nullptr;
-    std::map<std::string, std::shared_ptr<sim::data::IDataSet>> _values{};
+    std::map<std::string, Value> _values{};
+    std::map<std::string, double> _deadbands{};
+    std::vector<Field> _fields{};
+
+    Format _format = Format::OBJECTS;
+    int _precision = 0;
+    double _keepAlive = 0.0;
 
     bool _hasContent = false;
+    double _lastRowTime = 0.0;
+
+    bool _pending = false;
+    double _pendingTime = 0.0;
+    std::vector<sim::data::RowRing::Cell> _pendingCells{};
 
 
 public:
@@ -63,7 +118,12 @@ public:
         if(key == "time")
             throw std::invalid_argument("time key word is reserved.");
 
-        _values[key] = std::make_shared<sim::data::DataValue<T>>(val);
+        constexpr auto type = sim::data::dataTypeOf<T>();
+
+        if(type == sim::data::DataType::OTHER)
+            _values[key] = Value{type, val, std::make_shared<sim::data::DataValue<T>>(val)};
+        else
+            _values[key] = Value{type, val};
 
     }
 
@@ -79,6 +139,56 @@ public:
     }
 
 
+    /**
+     * Sets the output format
+     * @param format Format
+     */
+    void setFormat(Format format) {
+
+        _format = format;
+
+    }
+
+
+    /**
+     * Sets the number of significant digits of floating point values (incl. time). With zero (default), the
+     * values are written in the shortest representation, which is parsed back to the same value
+     * @param digits Number of significant digits
+     */
+    void setPrecision(int digits) {
+
+        _precision = digits;
+
+    }
+
+
+    /**
+     * Sets a deadband for a numeric value. The value is only written, when it moved more than the deadband since
+     * it was written last. With a deadband of zero, the value is written on every change
+     * @param key Key of the value
+     * @param threshold Deadband
+     */
+    void setDeadband(const std::string &key, double threshold) {
+
+        if(threshold < 0.0)
+            throw std::invalid_argument("deadband must not be negative.");
+
+        _deadbands[key] = threshold;
+
+    }
+
+
+    /**
+     * Sets the interval in which a complete row is written, even if no value changed
+     * @param interval Keep-alive interval (zero: no keep-alive rows)
+     */
+    void setKeepAlive(double interval) {
+
+        _keepAlive = interval;
+
+    }
+
+
 protected:
 
 
@@ -88,21 +198,8 @@ protected:
         if(!sim::ISynchronized::step(simTime))
             return false;
 
-        // save time and open object brackets
-        (*_outstream) << (_hasContent ? ",\n" : "[\n") << "\t" << R"({"time":)" << simTime << ",";
-
-        // write data
-        unsigned int i = 0;
-        for(auto &p : _values) {
-            (*_outstream) << (i++ == 0 ? "" : ",") << "\"" << p.first << "\":";
-            p.second->s(*_outstream);
-        }
-
-        // close object brackets
-        (*_outstream) << "}";
-
-        // save that data was already written
-        _hasContent = true;
+        // write current values
+        writeRow(simTime);
 
         // success
         return true;
@@ -118,6 +215,54 @@ protected:
         if(_outstream == nullptr)
             throw std::runtime_error("Output stream is not initialized.");
 
+        // precompute the constant fragments
+        _fields.clear();
+        _fields.reserve(_values.size());
+        for(auto &p : _values) {
+
+            std::string fragment(",");
+
+            if(_format == Format::OBJECTS) {
+                sim::data::appendJson(fragment, p.first);
+                fragment.push_back(':');
+            }
+
+            _fields.push_back(Field{std::move(fragment), p.second});
+
+        }
+
+        // set deadbands
+        for(auto &d : _deadbands) {
+
+            auto it = _values.find(d.first);
+            if(it == _values.end())
+                throw std::invalid_argument("deadband is set for an unknown key.");
+
+            double v;
+            if(!sim::data::toDouble(it->second.type, it->second.ptr, v))
+                throw std::invalid_argument("deadband is only supported for numeric values.");
+
+            _fields[std::distance(_values.begin(), it)].deadband = d.second;
+
+        }
+
+        _pendingCells.resize(_fields.size());
+        _pending = false;
+
+        // write key list
+        if(_format == Format::ROWS) {
+
+            std::string header(R"({"keys":["time")");
+            for(auto &p : _values) {
+                header.push_back(',');
+                sim::data::appendJson(header, p.first);
+            }
+            header.append(R"(],"rows":[)");
+
+            (*_outstream) << header;
+
+        }
+
         _hasContent = false;
 
     }
@@ -125,13 +270,175 @@ protected:
 
     void terminate(double simTime) override {
 
+        // write the last skipped row
+        if(_pending)
+            writeRow(_pendingTime, _pendingCells.data(), true);
+
         // close brackets
-        if(_hasContent)
+        if(_format == Format::ROWS)
+            (*_outstream) << "\n]}" << std::endl;
+        else if(_hasContent)
             (*_outstream) << "\n]" << std::endl;
 
     }
 
 
+    /**
+     * Writes a row to the out stream. The row is formatted into a thread-local buffer and written at once
+     * @param simTime Time of the row
+     * @param cells Snapshot of the values taken by snapshot() or nullptr to write the current values
+     * @param full Flag to write all values regardless of their deadband
+     */
+    void writeRow(double simTime, const sim::data::RowRing::Cell *cells = nullptr, bool full = false) {
+
+        // format row into buffer
+        thread_local std::string buf;
+        buf.clear();
+
+        if(!appendRow(buf, simTime, cells, full)) {
+
+            // save skipped row to write it at the end
+            _pending = true;
+            _pendingTime = simTime;
+
+            if(cells == nullptr)
+                snapshot(_pendingCells.data());
+            else
+                std::copy(cells, cells + _fields.size(), _pendingCells.begin());
+
+            return;
+
+        }
+
+        // write row at once
+        _outstream->write(buf.data(), static_cast<std::streamsize>(buf.size()));
+
+        // save that data was already written
+        _hasContent = true;
+        _lastRowTime = simTime;
+        _pending = false;
+
+    }
+
+
+    /**
+     * Copies the current values into the given cells (one cell per value)
+     * @param cells Cells to be written
+     * @return false, if a value is not a scalar and cannot be copied
+     */
+    bool snapshot(sim::data::RowRing::Cell *cells) const {
+
+        for(std::size_t i = 0; i < _fields.size(); ++i) {
+
+            auto copied = false;
+            sim::data::visit(_fields[i].value.type, _fields[i].value.ptr, [&cells, &copied, i] (auto value) {
+                using T = typename std::remove_const<typename std::remove_pointer<decltype(value)>::type>::type;
+                if constexpr (std::is_arithmetic<T>::value) {
+                    static_assert(sizeof(T) <= sizeof(sim::data::RowRing::Cell), "value exceeds cell size");
+                    std::memcpy(cells[i].bytes, value, sizeof(T));
+                    copied = true;
+                }
+            });
+
+            if(!copied)
+                return false;
+
+        }
+
+        return true;
+
+    }
+
+
+    /**
+     * Returns the number of values in a row
+     * @return Number of values
+     */
+    std::size_t numberOfValues() const {
+
+        return _fields.size();
+
+    }
+
+
+private:
+
+
+    /**
+     * Appends the JSON row of the values to the buffer
+     * @param buf Buffer
+     * @param simTime Time of the row
+     * @param cells Snapshot of the values or nullptr to take the current values
+     * @param full Flag to write all values regardless of their deadband
+     * @return false, if the row is skipped
+     */
+    bool appendRow(std::string &buf, double simTime, const sim::data::RowRing::Cell *cells, bool full) {
+
+        // first rows and keep-alive rows are written completely
+        full = full || !_hasContent || (_keepAlive > 0.0 && simTime + EPS_SIM_TIME >= _lastRowTime + _keepAlive);
+
+        // check values with deadband
+        auto filtered = false;
+        auto changed = false;
+        for(std::size_t i = 0; i < _fields.size(); ++i) {
+
+            auto &f = _fields[i];
+            if(f.deadband < 0.0)
+                continue;
+
+            auto &v = f.current;
+            sim::data::toDouble(f.value.type, cells == nullptr ? f.value.ptr : cells[i].bytes, v);
+
+            // a value turning into or out of NaN is always a change
+            f.changed = full || std::isnan(v) != std::isnan(f.last) || std::fabs(v - f.last) > f.deadband
+                    || (f.deadband == 0.0 && !std::isnan(v) && v != f.last);
+            changed = changed || f.changed;
+            filtered = true;
+
+        }
+
+        // skip row
+        if(filtered && !changed)
+            return false;
+
+        // only values which are actually written are the reference for the deadband
+        for(auto &f : _fields) {
+
+            if(f.deadband >= 0.0 && (f.changed || _format == Format::ROWS))
+                f.last = f.current;
+
+        }
+
+        // save time and open brackets
+        if(_format == Format::ROWS)
+            buf.append(_hasContent ? ",\n[" : "\n[");
+        else
+            buf.append(_hasContent ? ",\n\t{\"time\":" : "[\n\t{\"time\":");
+
+        sim::data::appendJson(buf, simTime, _precision);
+
+        // write data
+        for(std::size_t i = 0; i < _fields.size(); ++i) {
+
+            auto &f = _fields[i];
+            if(_format == Format::OBJECTS && f.deadband >= 0.0 && !f.changed)
+                continue;
+
+            buf.append(f.fragment);
+
+            if(!sim::data::appendJson(buf, f.value.type, cells == nullptr ? f.value.ptr : cells[i].bytes, _precision))
+                f.value.data->json(buf);
+
+        }
+
+        // close brackets
+        buf.push_back(_format == Format::ROWS ? ']' : '}');
+
+        return true;
+
+    }
+
+
 };
 
 
@@ -33,7 +33,11 @@
 #include <memory>
 #include <map>
 #include <vector>
+#include <cmath>
+#include <algorithm>
 #include "../ISynchronized.h"
+#include "Downsampler.h"
+#include "TypedArray.h"
 
 class PlotLogger : public sim::ISynchronized {
 
@@ -64,6 +68,33 @@ class PlotLogger : public sim::ISynchronized {
     std::string _dataFile{};
     std::vector<double*> _values{};
 
+    std::map<std::string, double> _deadbands{};
+    std::vector<double> _fieldDeadbands{}; // per field, negative: no deadband
+    std::vector<double> _last{};
+    std::vector<double> _pendingRow{};
+    double _keepAlive = 0.0;
+    double _time = 0.0;
+    double _lastRowTime = 0.0;
+    bool _pending = false;
+
+    sim::data::Downsampling _downsampling = sim::data::Downsampling::NONE;
+    size_t _maxPoints = 0;
+    std::vector<std::pair<Trace*, size_t>> _sampledTraces{}; // trace, sampler index
+    std::vector<std::pair<size_t, size_t>> _samplerFields{};  // x field, y field
+    std::vector<sim::data::Downsampler> _samplers{};
+
+    sim::data::TypedArrayWriter _arrays{};
+    std::string _sidecarFile{};
+    std::fstream _sidecar;
+    static constexpr size_t binaryChunkSize = 4096; // rows per chunk of a binary dataset, if not set
+
+    size_t _chunkSize = 0;
+    size_t _chunkCapacity = 0; // rows per chunk in use
+    size_t _chunkRows = 0;
+    std::vector<double> _chunk{}; // column-major buffer of the current chunk
+    bool _firstChunk = true;
+    bool _filtered = false;
+
     bool _locked = false;
     bool _firstRow = true;
 
@@ -179,10 +210,101 @@ public:
     }
 
 
+    /**
+     * Sets a deadband for a dataset field. A row is only written, when at least one field with a deadband moved
+     * more than its deadband since the last written row (with a deadband of zero: on every change). Fields without
+     * deadband do not trigger rows. The first row, keep-alive rows and a final row for the last skipped step are
+     * always written, so each field can be reconstructed by its last written value with an error not greater than
+     * its deadband
+     * @param field Field name
+     * @param threshold Deadband
+     */
+    void setDeadband(const std::string &field, double threshold) {
+
+        if(_locked)
+            throw std::runtime_error("The file has been locked.");
+
+        if(threshold < 0.0)
+            throw std::invalid_argument("deadband must not be negative.");
+
+        _deadbands[field] = threshold;
+
+    }
+
+
+    /**
+     * Sets the interval in which a row is written, even if no field changed
+     * @param interval Keep-alive interval (zero: no keep-alive rows)
+     */
+    void setKeepAlive(double interval) {
+
+        _keepAlive = interval;
+
+    }
+
+
+    /**
+     * Enables downsampling of the dataset. Instead of writing the dataset, each trace referencing two dataset fields
+     * is downsampled online and written with its data, when the file is closed. The memory and the size of the file
+     * are bounded by the maximum number of points per trace, independent of the duration of the simulation
+     * @param mode Downsampling mode (MINMAX keeps the peaks of each bucket, LTTB keeps the visual shape)
+     * @param maxPoints Maximum number of points per trace
+     */
+    void setDownsampling(sim::data::Downsampling mode, size_t maxPoints) {
+
+        if(_locked)
+            throw std::runtime_error("The file has been locked.");
+
+        if(mode != sim::data::Downsampling::NONE && maxPoints < 4)
+            throw std::invalid_argument("maximum number of points must be at least four.");
+
+        _downsampling = mode;
+        _maxPoints = maxPoints;
+
+    }
+
+
+    /**
+     * Sets the encoding of trace data and the dataset. With a binary encoding, the arrays are written as little-endian
+     * typed arrays ({"dtype":"float64","data":"<base64>"}), which can be loaded as Float64Array or Float32Array without
+     * parsing. If a sidecar file is given, the raw data is written to this file and referenced by offset (in bytes)
+     * and length (in elements). With a binary encoding, the dataset is always written in chunks of column arrays (see
+     * setColumnar, 4096 rows per chunk if no chunk size is set), so the memory does not grow with the run
+     * @param encoding Array encoding
+     * @param sidecarFile Binary file to store the data (empty: data is written inline)
+     */
+    void setEncoding(sim::data::ArrayEncoding encoding, const std::string &sidecarFile = "") {
+
+        if(_locked)
+            throw std::runtime_error("The file has been locked.");
+
+        _arrays.setEncoding(encoding);
+        _sidecarFile = encoding == sim::data::ArrayEncoding::TEXT ? "" : sidecarFile;
+
+    }
+
+
+    /**
+     * Enables the columnar dataset. The values are stored in a contiguous column-major buffer and written in chunks
+     * of column arrays ({"chunks":[{"field":[...],...},...]}), which can be consumed by plotting libraries directly.
+     * The arrays are written with the encoding set by setEncoding()
+     * @param chunkSize Number of rows per chunk (zero: row objects are written, if the encoding is TEXT)
+     */
+    void setColumnar(size_t chunkSize) {
+
+        if(_locked)
+            throw std::runtime_error("The file has been locked.");
+
+        _chunkSize = chunkSize;
+
+    }
+
+
     void writeHeader() {
 
-        _firstRow = true;
-        _locked = true;
+        // lock definition if not done yet
+        if(!_locked)
+            lock();
 
         _file << R"({"title":")" << _title.c_str() << R"(",)"
                  R"("plots":[)";
@@ -208,17 +330,32 @@ public:
                 std::stringstream xData;
                 std::stringstream yData;
 
-                // store x values
-                for(unsigned int j = 0; j < tr->x.size(); ++j)
-                    xData << (j == 0 ? "[" : ",") << tr->x.at(j);
+                if(_arrays.encoding() == sim::data::ArrayEncoding::TEXT) {
+
+                    // store x values
+                    for(unsigned int j = 0; j < tr->x.size(); ++j)
+                        xData << (j == 0 ? "[" : ",") << tr->x.at(j);
+
+                    // store y data
+                    for(unsigned int j = 0; j < tr->y.size(); ++j)
+                        yData << (j == 0 ? "[" : ",") << tr->y.at(j);
+
+                    // set closing bracket
+                    xData << "]";
+                    yData << "]";
+
+                } else {
+
+                    // store typed arrays
+                    std::string buf;
+                    _arrays.write(buf, tr->x.data(), tr->x.size());
+                    xData << buf;
 
-                // store y data
-                for(unsigned int j = 0; j < tr->y.size(); ++j)
-                    yData << (j == 0 ? "[" : ",") << tr->y.at(j);
+                    buf.clear();
+                    _arrays.write(buf, tr->y.data(), tr->y.size());
+                    yData << buf;
 
-                // set closing bracket
-                xData << "]";
-                yData << "]";
+                }
 
                 // set xRef, yRef
                 std::stringstream xRef, yRef;
@@ -247,7 +384,8 @@ public:
             _file << std::endl << R"(],"datafile":")" << _dataFile << "\"}";
             _file.close();
         } else
-            _file << std::endl << R"(],"dataset":[)";
+            _file << std::endl << (columnar() ? R"(],"dataset":{"chunks":[)"
+                                 : R"(],"dataset":[)");
 
     }
 
@@ -256,19 +394,63 @@ public:
 
         // write header if not written yet
         if(!_locked)
-            writeHeader();
+            begin();
 
         // check if data file is defined
         if(!_dataFile.empty())
             return;
 
+        // store values directly to the chunk
+        if(!_filtered && columnar()) {
+
+            auto n = _fields.size();
+            for(size_t i = 0; i < n; ++i)
+                _chunk[i * _chunkCapacity + _chunkRows] = *_values[i];
+
+            if(++_chunkRows == _chunkCapacity)
+                writeChunk();
+
+            _lastRowTime = _time;
+            return;
+
+        }
+
+        // check deadbands
+        auto changed = _firstRow || (_keepAlive > 0.0 && _time + EPS_SIM_TIME >= _lastRowTime + _keepAlive);
+        auto filtered = false;
+        for(size_t i = 0; i < _fields.size(); ++i) {
+
+            if(_fieldDeadbands[i] < 0.0)
+                continue;
+
+            auto v = *_values[i];
+            auto db = _fieldDeadbands[i];
+            filtered = true;
+
+            // a value turning into or out of NaN is always a change
+            changed = changed || std::isnan(v) != std::isnan(_last[i]) || std::fabs(v - _last[i]) > db
+                    || (db == 0.0 && !std::isnan(v) && v != _last[i]);
+
+        }
+
+        // skip row and keep it for the end
+        if(filtered && !changed) {
+
+            for(size_t i = 0; i < _fields.size(); ++i)
+                _pendingRow[i] = *_values[i];
+
+            _pending = true;
+            return;
+
+        }
+
         // write row
-        _file << (_firstRow ? "" : ",") << "{";
         for(size_t i = 0; i < _fields.size(); ++i)
-            _file << (i == 0 ? "" : ",") << "\"" << _fields.at(i).c_str() << "\":" << *_values.at(i);
-        _file << "}";
+            _last[i] = *_values[i];
 
-        _firstRow = false;
+        writeRow(_last);
+        _lastRowTime = _time;
+        _pending = false;
 
     }
 
@@ -277,14 +459,46 @@ public:
 
         // write header if not written yet
         if(!_locked)
-            writeHeader();
+            begin();
 
         // check if data file is defined
-        if(_dataFile.empty())
-            _file << "]}";
+        if(_dataFile.empty()) {
+
+            // write the last skipped row
+            if(_pending)
+                writeRow(_pendingRow);
+
+            // write downsampled traces with the header
+            if(_downsampling != sim::data::Downsampling::NONE) {
+
+                for(auto &t : _sampledTraces)
+                    _samplers[t.second].result(t.first->x, t.first->y);
+
+                writeHeader();
+
+            }
+
+            // write columns
+            if(columnar()) {
+
+                if(_chunkRows > 0)
+                    writeChunk();
+
+                _file << "]}}";
+
+            } else {
+
+                _file << "]}";
+
+            }
+
+        }
 
         _file.close();
 
+        if(_sidecar.is_open())
+            _sidecar.close();
+
     }
 
     void initialize(double initTime) override {
@@ -295,8 +509,17 @@ public:
         // create and open file
         _file = std::fstream(_filename.c_str(), std::ios::out);
 
-        // write header
-        writeHeader();
+        // create and open sidecar file
+        if(!_sidecarFile.empty()) {
+            _sidecar = std::fstream(_sidecarFile.c_str(), std::ios::out | std::ios::binary);
+            _arrays.setSidecar(&_sidecar, _sidecarFile);
+        } else {
+            _arrays.setSidecar(nullptr, "");
+        }
+
+        // write header (when downsampled, the header is written on close)
+        _locked = false;
+        begin();
 
     }
 
@@ -307,6 +530,7 @@ public:
             return false;
 
         // write data
+        _time = simTime;
         writeData();
 
         // do nothing
@@ -321,6 +545,150 @@ public:
 
     }
 
+
+private:
+
+
+    bool columnar() const {
+
+        // binary datasets are always written in chunks
+        return (_chunkSize > 0 || _arrays.encoding() != sim::data::ArrayEncoding::TEXT)
+               && _downsampling == sim::data::Downsampling::NONE;
+
+    }
+
+
+    void begin() {
+
+        if(_downsampling == sim::data::Downsampling::NONE)
+            writeHeader();
+        else
+            lock();
+
+    }
+
+
+    void lock() {
+
+        _firstRow = true;
+        _locked = true;
+        _pending = false;
+
+        // resolve deadbands
+        _fieldDeadbands.assign(_fields.size(), -1.0);
+        for(auto &d : _deadbands) {
+
+            auto it = std::find(_fields.begin(), _fields.end(), d.first);
+            if(it == _fields.end())
+                throw std::invalid_argument("deadband is set for an unknown field.");
+
+            _fieldDeadbands[std::distance(_fields.begin(), it)] = d.second;
+
+        }
+
+        _last.assign(_fields.size(), 0.0);
+        _pendingRow.assign(_fields.size(), 0.0);
+
+        // allocate chunk
+        _filtered = !_deadbands.empty();
+        _chunkCapacity = _chunkSize > 0 ? _chunkSize : binaryChunkSize;
+        _chunk.assign(columnar() ? _fields.size() * _chunkCapacity : 0, 0.0);
+        _chunkRows = 0;
+        _firstChunk = true;
+
+        // create one sampler per referenced pair of fields
+        _sampledTraces.clear();
+        _samplerFields.clear();
+        _samplers.clear();
+
+        if(_downsampling == sim::data::Downsampling::NONE)
+            return;
+
+        if(!_dataFile.empty())
+            throw std::invalid_argument("downsampling requires a dataset.");
+
+        for(auto &fig : _figures) {
+            for(auto &tr : fig->traces) {
+
+                auto xf = std::find(_fields.begin(), _fields.end(), tr.xRef);
+                auto yf = std::find(_fields.begin(), _fields.end(), tr.yRef);
+
+                if(!tr.x.empty() || xf == _fields.end() || yf == _fields.end())
+                    continue;
+
+                std::pair<size_t, size_t> f{std::distance(_fields.begin(), xf), std::distance(_fields.begin(), yf)};
+
+                // traces with equal fields share the sampler
+                auto it = std::find(_samplerFields.begin(), _samplerFields.end(), f);
+                if(it == _samplerFields.end()) {
+                    _samplerFields.push_back(f);
+                    _samplers.emplace_back(_downsampling, _maxPoints);
+                    it = std::prev(_samplerFields.end());
+                }
+
+                _sampledTraces.emplace_back(&tr, std::distance(_samplerFields.begin(), it));
+
+            }
+        }
+
+    }
+
+
+    void writeChunk() {
+
+        std::string buf(_firstChunk ? "\n{" : ",\n{");
+        for(size_t i = 0; i < _fields.size(); ++i) {
+
+            buf.append(i == 0 ? "\"" : ",\"").append(_fields[i]).append("\":");
+            _arrays.write(buf, &_chunk[i * _chunkCapacity], _chunkRows);
+
+        }
+
+        buf.push_back('}');
+        _file << buf;
+
+        _chunkRows = 0;
+        _firstChunk = false;
+
+    }
+
+
+    void writeRow(const std::vector<double> &row) {
+
+        // add to samplers
+        if(_downsampling != sim::data::Downsampling::NONE) {
+
+            for(size_t i = 0; i < _samplers.size(); ++i)
+                _samplers[i].add(row[_samplerFields[i].first], row[_samplerFields[i].second]);
+
+            _firstRow = false;
+            return;
+
+        }
+
+        // add to chunk
+        if(columnar()) {
+
+            for(size_t i = 0; i < _fields.size(); ++i)
+                _chunk[i * _chunkCapacity + _chunkRows] = row[i];
+
+            if(++_chunkRows == _chunkCapacity)
+                writeChunk();
+
+            _firstRow = false;
+            return;
+
+        }
+
+        _file << (_firstRow ? "" : ",") << "{";
+        for(size_t i = 0; i < _fields.size(); ++i)
+            _file << (i == 0 ? "" : ",") << "\"" << _fields.at(i).c_str() << "\":" << row[i];
+        _file << "}";
+
+        _firstRow = false;
+
+    }
+
 };
 
 
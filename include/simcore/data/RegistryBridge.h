@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <type_traits>
+
+#include "../IStorable.h"
+#include "DataType.h"
+#include "Registry.h"
+
+namespace sim::data {
+
+// Publishes a typed value under the given name. The entry refers to the value
+// itself, nothing is copied. Returns false for unsupported types.
+inline bool publishValue(Registry& registry, const std::string& name,
+                         DataType type, const void* ptr) {
+  return visit(type, ptr, [&registry, &name](auto value) {
+    using T = std::remove_const_t<std::remove_pointer_t<decltype(value)>>;
+    registry.publish(name, const_cast<T*>(value));
+  });
+}
+
+// Publishes all parameter, input and state entries of the storable as
+// "owner.context.name". Field tables are used if available, otherwise the
+// data entries. Entries of unsupported types are skipped. Returns the number
+// of published entries.
+inline std::size_t publishStorable(Registry& registry, const std::string& owner,
+                                   const IStorable& store) {
+  static const IStorable::Context contexts[] = {
+      IStorable::PARAMETER, IStorable::INPUT, IStorable::STATE};
+
+  std::size_t count = 0;
+  for (auto context : contexts) {
+    auto prefix = owner + "." + IStorable::contextName(context) + ".";
+    auto table = store.getFields(context);
+    if (table.size != 0) {
+      for (std::size_t i = 0; i < table.size; ++i)
+        count += publishValue(registry, prefix + table.fields[i].name,
+                              table.fields[i].type, table.pointer(i));
+    } else {
+      for (const auto& e : store.getData(context))
+        count += publishValue(registry, prefix + e.name, e.data->type(),
+                              e.data->v());
+    }
+  }
+
+  return count;
+}
+
+}  // namespace sim::data
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_ROWRING_H
+#define SIMCORE_ROWRING_H
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+namespace sim {
+namespace data {
+
+
+    /**
+     * A lock-free single-producer single-consumer ring of fixed-width rows. Each row consists of cells of eight
+     * bytes, which can hold any scalar value. The memory is allocated once in resize()
+     */
+    class RowRing {
+
+    public:
+
+        struct Cell {
+            alignas(8) unsigned char bytes[8];
+        };
+
+
+    private:
+
+        std::vector<Cell> _cells{};
+        std::size_t _width = 0;
+        std::size_t _capacity = 0;
+
+        std::atomic<std::size_t> _head{0}; // number of rows committed (written by producer)
+        std::atomic<std::size_t> _tail{0}; // number of rows released (written by consumer)
+
+
+    public:
+
+
+        /**
+         * Allocates the ring and drops all rows. Must not be called while producer or consumer are active
+         * @param capacity Number of rows
+         * @param width Number of cells per row
+         */
+        void resize(std::size_t capacity, std::size_t width) {
+
+            _cells.assign(capacity * width, Cell{});
+            _width = width;
+            _capacity = capacity;
+
+            _head.store(0);
+            _tail.store(0);
+
+        }
+
+
+        /**
+         * Returns the next free row (producer side)
+         * @return Pointer to the row or nullptr, if the ring is full
+         */
+        Cell *acquire() {
+
+            auto head = _head.load(std::memory_order_relaxed);
+            if(head - _tail.load(std::memory_order_acquire) >= _capacity)
+                return nullptr;
+
+            return &_cells[(head % _capacity) * _width];
+
+        }
+
+
+        /**
+         * Publishes the row returned by acquire() to the consumer (producer side)
+         */
+        void commit() {
+
+            _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+
+        }
+
+
+        /**
+         * Returns the oldest committed row (consumer side)
+         * @return Pointer to the row or nullptr, if the ring is empty
+         */
+        const Cell *front() const {
+
+            auto tail = _tail.load(std::memory_order_relaxed);
+            if(tail == _head.load(std::memory_order_acquire))
+                return nullptr;
+
+            return &_cells[(tail % _capacity) * _width];
+
+        }
+
+
+        /**
+         * Releases the row returned by front() (consumer side)
+         */
+        void pop() {
+
+            _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+
+        }
+
+
+        /**
+         * Returns the number of rows the ring can hold
+         * @return Capacity
+         */
+        std::size_t capacity() const {
+
+            return _capacity;
+
+        }
+
+    };
+
+
+}} // namespace ::sim::data
+
+
+#endif //SIMCORE_ROWRING_H
@@ -0,0 +1,296 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_TYPEDARRAY_H
+#define SIMCORE_TYPEDARRAY_H
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include "JsonFormat.h"
+
+namespace sim {
+namespace data {
+
+
+    /**
+     * Encodings of numeric arrays
+     */
+    enum class ArrayEncoding {
+        TEXT,    //!< JSON array of decimal numbers
+        FLOAT64, //!< little-endian IEEE 754 double precision (Float64Array)
+        FLOAT32  //!< little-endian IEEE 754 single precision (Float32Array)
+    };
+
+
+    /**
+     * A streaming base64 encoder, which appends the encoded data to a string
+     */
+    class Base64Encoder {
+
+        std::string &_out;
+        unsigned char _buf[3]{};
+        std::size_t _n = 0;
+
+
+    public:
+
+
+        /**
+         * Constructor
+         * @param out String to be appended
+         */
+        explicit Base64Encoder(std::string &out) : _out(out) {}
+
+
+        /**
+         * Encodes the given bytes. Incomplete groups of three bytes are kept for the next call
+         * @param data Data
+         * @param size Number of bytes
+         */
+        void write(const void *data, std::size_t size) {
+
+            auto p = static_cast<const unsigned char *>(data);
+
+            for(std::size_t i = 0; i < size; ++i) {
+
+                _buf[_n++] = p[i];
+
+                if(_n == 3) {
+                    encode(3);
+                    _n = 0;
+                }
+
+            }
+
+        }
+
+
+        /**
+         * Encodes the remaining bytes with padding
+         */
+        void finish() {
+
+            if(_n == 0)
+                return;
+
+            for(auto i = _n; i < 3; ++i)
+                _buf[i] = 0;
+
+            encode(_n);
+            _n = 0;
+
+        }
+
+
+    private:
+
+
+        void encode(std::size_t n) {
+
+            static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+            std::uint32_t v = (static_cast<std::uint32_t>(_buf[0]) << 16u)
+                            | (static_cast<std::uint32_t>(_buf[1]) << 8u)
+                            | static_cast<std::uint32_t>(_buf[2]);
+
+            _out.push_back(table[(v >> 18u) & 0x3fu]);
+            _out.push_back(table[(v >> 12u) & 0x3fu]);
+            _out.push_back(n > 1 ? table[(v >> 6u) & 0x3fu] : '=');
+            _out.push_back(n > 2 ? table[v & 0x3fu] : '=');
+
+        }
+
+    };
+
+
+    /**
+     * Writes numeric arrays as JSON values. Binary encoded arrays are written as objects with the data type and either
+     * the base64 encoded little-endian data ({"dtype":"float64","data":"..."}) or, if a sidecar stream is set, the
+     * position of the raw data in the sidecar file ({"dtype":"float64","file":"...","offset":0,"length":10}, offset
+     * in bytes, length in elements)
+     */
+    class TypedArrayWriter {
+
+        ArrayEncoding _encoding = ArrayEncoding::TEXT;
+        std::ostream *_sidecar = nullptr;
+        std::string _sidecarName{};
+        std::uint64_t _offset = 0;
+
+
+    public:
+
+
+        /**
+         * Constructor
+         * @param encoding Array encoding
+         */
+        explicit TypedArrayWriter(ArrayEncoding encoding = ArrayEncoding::TEXT) : _encoding(encoding) {}
+
+
+        /**
+         * Sets the encoding
+         * @param encoding Array encoding
+         */
+        void setEncoding(ArrayEncoding encoding) {
+
+            _encoding = encoding;
+
+        }
+
+
+        /**
+         * Returns the encoding
+         * @return Array encoding
+         */
+        ArrayEncoding encoding() const {
+
+            return _encoding;
+
+        }
+
+
+        /**
+         * Sets the stream of the sidecar file, to which binary data is written. The name is referenced in the JSON
+         * value. The offset is reset
+         * @param sidecar Sidecar stream (nullptr: data is written inline)
+         * @param name File name to be referenced
+         */
+        void setSidecar(std::ostream *sidecar, std::string name) {
+
+            _sidecar = sidecar;
+            _sidecarName = std::move(name);
+            _offset = 0;
+
+        }
+
+
+        /**
+         * Appends the array as JSON value to the given string
+         * @param out String to be appended
+         * @param values Values
+         * @param n Number of values
+         */
+        void write(std::string &out, const double *values, std::size_t n) {
+
+            if(_encoding == ArrayEncoding::TEXT) {
+
+                out.push_back('[');
+                for(std::size_t i = 0; i < n; ++i) {
+                    if(i != 0)
+                        out.push_back(',');
+                    appendJson(out, values[i], streamPrecision);
+                }
+                out.push_back(']');
+
+                return;
+
+            }
+
+            auto width = _encoding == ArrayEncoding::FLOAT64 ? 8u : 4u;
+
+            out.append(R"({"dtype":")");
+            out.append(_encoding == ArrayEncoding::FLOAT64 ? "float64" : "float32");
+
+            if(_sidecar != nullptr) {
+
+                out.append(R"(","file":)");
+                appendJson(out, _sidecarName);
+                out.append(R"(,"offset":)");
+                appendJson(out, _offset);
+                out.append(R"(,"length":)");
+                appendJson(out, n);
+                out.push_back('}');
+
+                encode(values, n, [this] (const unsigned char *data, std::size_t size) {
+                    _sidecar->write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+                });
+
+                _offset += n * width;
+
+                return;
+
+            }
+
+            out.append(R"(","data":")");
+
+            Base64Encoder b64(out);
+            encode(values, n, [&b64] (const unsigned char *data, std::size_t size) {
+                b64.write(data, size);
+            });
+            b64.finish();
+
+            out.append(R"("})");
+
+        }
+
+
+    private:
+
+
+        /**
+         * Converts the values to little-endian bytes in blocks and passes the blocks to the sink
+         */
+        template<typename Sink>
+        void encode(const double *values, std::size_t n, Sink &&sink) const {
+
+            unsigned char block[4096];
+            std::size_t size = 0;
+
+            for(std::size_t i = 0; i < n; ++i) {
+
+                std::uint64_t bits;
+                unsigned int width;
+
+                if(_encoding == ArrayEncoding::FLOAT64) {
+                    std::memcpy(&bits, &values[i], 8);
+                    width = 8;
+                } else {
+                    auto f = static_cast<float>(values[i]);
+                    std::uint32_t b;
+                    std::memcpy(&b, &f, 4);
+                    bits = b;
+                    width = 4;
+                }
+
+                for(unsigned int j = 0; j < width; ++j)
+                    block[size++] = static_cast<unsigned char>((bits >> (8u * j)) & 0xffu);
+
+                if(size + 8 > sizeof(block)) {
+                    sink(block, size);
+                    size = 0;
+                }
+
+            }
+
+            if(size > 0)
+                sink(block, size);
+
+        }
+
+    };
+
+}} // namespace sim::data
+
+#endif // SIMCORE_TYPEDARRAY_H
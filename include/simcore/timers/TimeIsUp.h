@@ -71,8 +71,10 @@ public:
     bool step(double simTime) override {
 
         // set status to ended if time is reached
-        if(simTime >= (_stopTime - EPS_TIME))
+        if(simTime >= (_stopTime - EPS_TIME) && !hasStopped()) {
+            setEvent(_stopTime, _stopTime);
             end();
+        }
 
         return true;
 
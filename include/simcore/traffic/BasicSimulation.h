@@ -31,7 +31,7 @@
 #include <simcore/timers/BasicTimer.h>
 #include <simcore/timers/RealTimeTimer.h>
 #include <simcore/timers/TimeIsUp.h>
-#include <simcore/value/ValueExceed.h>
+#include <simcore/value/ThresholdSet.h>
 #include "simcore/data/PlotLogger.h"
 
 class BasicSimulation : public sim::Loop {
@@ -42,7 +42,7 @@ protected:
     std::unique_ptr<TimeReporter> timeReporter;
     std::unique_ptr<TimeIsUp> stopTimer;
 
-    std::vector<std::unique_ptr<ValueExceed<double>>> stopConditions;
+    std::unique_ptr<ThresholdSet> stopConditions;
 
 
 public:
@@ -0,0 +1,576 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_EXPRESSIONCONDITION_H
+#define SIMCORE_EXPRESSIONCONDITION_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cmath>
+#include <stdexcept>
+#include "../IStopCondition.h"
+#include "../IComponent.h"
+#include "../data/Registry.h"
+#include "../data/DataType.h"
+
+/**
+ * A stop condition defined by an expression over values of a registry, e.g.
+ *
+ *     ego.speed > 30 and distance < 5 for 0.5 s
+ *
+ * The expression supports numbers, true and false, registry names (letters, digits, '_' and '.', or any name in
+ * double quotes), the arithmetic operators + - * /, the comparisons < <= > >= == !=, the logical operators and (&&),
+ * or (||) and not (!) and parentheses. A trailing "for <time>" requires the expression to be true for the given
+ * duration (in seconds) before the simulation is stopped.
+ *
+ * The expression is parsed once. The names are resolved to pointers and the expression is compiled to a register
+ * based bytecode with typed loads, which is executed in each step without allocation
+ */
+class ExpressionCondition : public ::sim::IStopCondition, public ::sim::IComponent {
+
+public:
+
+    typedef IStopCondition::StopCode Mode;
+
+
+private:
+
+    enum class Op : unsigned char {
+        CONST,
+        LOAD_BOOL, LOAD_INT, LOAD_UINT, LOAD_LONG, LOAD_ULONG, LOAD_LLONG, LOAD_ULLONG, LOAD_FLOAT, LOAD_DOUBLE,
+        NEG, ADD, SUB, MUL, DIV,
+        LT, LE, GT, GE, EQ, NE,
+        AND, OR, NOT
+    };
+
+    struct Instruction {
+        Op op;
+        unsigned int dst;
+        unsigned int a;
+        unsigned int b;
+        const void *ptr;
+        double value;
+    };
+
+    struct Token {
+        enum class Type { END, NUMBER, NAME, OPERATOR, LPAREN, RPAREN } type;
+        std::string text;
+        double number;
+        bool quoted;
+    };
+
+    IStopCondition::StopCode _mode = IStopCondition::StopCode::SIM_ENDED;
+
+    std::string _expression{};
+    std::vector<Instruction> _code{};
+    std::vector<double> _registers{};
+
+    double _hold = 0.0;
+    double _since = -1.0;
+
+    // parser state (only used while compiling)
+    std::vector<Instruction> _compiled{};
+    std::vector<Token> _tokens{};
+    size_t _pos = 0;
+    const sim::data::Registry *_registry = nullptr;
+
+
+public:
+
+
+    ExpressionCondition() = default;
+
+
+    /**
+     * Parses and compiles the expression. The names are resolved in the registry, the values must be published
+     * before and must stay valid while the condition is used. If the expression is rejected, the previous expression
+     * stays active
+     * @param expression Expression
+     * @param registry Registry to resolve the names
+     * @param mode Stop code to be set
+     */
+    void setExpression(const std::string &expression, const sim::data::Registry &registry, Mode mode = Mode::SIM_ENDED) {
+
+        _compiled.clear();
+        _registry = &registry;
+
+        double hold = 0.0;
+        unsigned int registers = 1;
+
+        try {
+
+            tokenize(expression);
+
+            // compile
+            _pos = 0;
+            parseOr(0, registers);
+
+            // hold time
+            if(isKeyword("for")) {
+
+                ++_pos;
+
+                if(_tokens[_pos].type != Token::Type::NUMBER)
+                    error("duration expected after 'for'");
+
+                hold = _tokens[_pos++].number;
+
+                if(_tokens[_pos].type == Token::Type::NAME && _tokens[_pos].text == "s")
+                    ++_pos;
+
+            }
+
+            if(_tokens[_pos].type != Token::Type::END)
+                error("unexpected '" + _tokens[_pos].text + "'");
+
+        } catch(...) {
+
+            releaseParser();
+            throw;
+
+        }
+
+        // take over the compiled expression
+        _code.swap(_compiled);
+        _registers.assign(registers, 0.0);
+        _expression = expression;
+        _hold = hold;
+        _mode = mode;
+
+        releaseParser();
+
+    }
+
+
+    /**
+     * Returns the expression
+     * @return Expression
+     */
+    const std::string &expression() const {
+
+        return _expression;
+
+    }
+
+
+    /**
+     * Returns the hold time
+     * @return Time the expression must be true (in seconds)
+     */
+    double holdTime() const {
+
+        return _hold;
+
+    }
+
+
+    /**
+     * Evaluates the expression with the current values. Throws, if no expression is set
+     * @return Result (non-zero values are true)
+     */
+    double evaluate() {
+
+        if(_code.empty())
+            throw std::runtime_error("Expression is not set.");
+
+        auto r = _registers.data();
+
+        for(auto &in : _code) {
+
+            switch(in.op) {
+                case Op::CONST:       r[in.dst] = in.value; break;
+                case Op::LOAD_BOOL:   r[in.dst] = *static_cast<const bool *>(in.ptr) ? 1.0 : 0.0; break;
+                case Op::LOAD_INT:    r[in.dst] = *static_cast<const int *>(in.ptr); break;
+                case Op::LOAD_UINT:   r[in.dst] = *static_cast<const unsigned int *>(in.ptr); break;
+                case Op::LOAD_LONG:   r[in.dst] = static_cast<double>(*static_cast<const long *>(in.ptr)); break;
+                case Op::LOAD_ULONG:  r[in.dst] = static_cast<double>(*static_cast<const unsigned long *>(in.ptr)); break;
+                case Op::LOAD_LLONG:  r[in.dst] = static_cast<double>(*static_cast<const long long *>(in.ptr)); break;
+                case Op::LOAD_ULLONG: r[in.dst] = static_cast<double>(*static_cast<const unsigned long long *>(in.ptr)); break;
+                case Op::LOAD_FLOAT:  r[in.dst] = *static_cast<const float *>(in.ptr); break;
+                case Op::LOAD_DOUBLE: r[in.dst] = *static_cast<const double *>(in.ptr); break;
+                case Op::NEG:         r[in.dst] = -r[in.a]; break;
+                case Op::ADD:         r[in.dst] = r[in.a] + r[in.b]; break;
+                case Op::SUB:         r[in.dst] = r[in.a] - r[in.b]; break;
+                case Op::MUL:         r[in.dst] = r[in.a] * r[in.b]; break;
+                case Op::DIV:         r[in.dst] = r[in.a] / r[in.b]; break;
+                case Op::LT:          r[in.dst] = r[in.a] <  r[in.b] ? 1.0 : 0.0; break;
+                case Op::LE:          r[in.dst] = r[in.a] <= r[in.b] ? 1.0 : 0.0; break;
+                case Op::GT:          r[in.dst] = r[in.a] >  r[in.b] ? 1.0 : 0.0; break;
+                case Op::GE:          r[in.dst] = r[in.a] >= r[in.b] ? 1.0 : 0.0; break;
+                case Op::EQ:          r[in.dst] = r[in.a] == r[in.b] ? 1.0 : 0.0; break;
+                case Op::NE:          r[in.dst] = r[in.a] != r[in.b] ? 1.0 : 0.0; break;
+                case Op::AND:         r[in.dst] = r[in.a] != 0.0 && r[in.b] != 0.0 ? 1.0 : 0.0; break;
+                case Op::OR:          r[in.dst] = r[in.a] != 0.0 || r[in.b] != 0.0 ? 1.0 : 0.0; break;
+                case Op::NOT:         r[in.dst] = r[in.a] == 0.0 ? 1.0 : 0.0; break;
+            }
+
+        }
+
+        return r[0];
+
+    }
+
+
+    void initialize(double initTime) override {
+
+        if(_code.empty())
+            throw std::runtime_error("Expression is not set.");
+
+        reset();
+        _since = -1.0;
+
+    }
+
+
+    bool step(double simTime) override {
+
+        // check expression
+        if(evaluate() == 0.0 || std::isnan(_registers[0])) {
+            _since = -1.0;
+            return true;
+        }
+
+        // check hold time
+        if(_since < 0.0)
+            _since = simTime;
+
+        if(simTime - _since + 1e-9 >= _hold && !hasStopped()) {
+            setEvent(simTime, _registers[0]);
+            stop(_mode);
+        }
+
+        return true;
+
+    }
+
+
+    void terminate(double simTime) override {
+
+    }
+
+
+private:
+
+
+    void releaseParser() {
+
+        _compiled.clear();
+        _tokens.clear();
+        _registry = nullptr;
+
+    }
+
+
+    [[noreturn]] void error(const std::string &message) const {
+
+        throw std::invalid_argument("expression: " + message);
+
+    }
+
+
+    void tokenize(const std::string &str) {
+
+        _tokens.clear();
+
+        size_t i = 0;
+        while(i < str.size()) {
+
+            auto c = str[i];
+
+            if(std::isspace(static_cast<unsigned char>(c))) {
+                ++i;
+                continue;
+            }
+
+            // number
+            if(std::isdigit(static_cast<unsigned char>(c)) || (c == '.' && i + 1 < str.size()
+                    && std::isdigit(static_cast<unsigned char>(str[i + 1])))) {
+
+                char *end = nullptr;
+                auto v = std::strtod(str.c_str() + i, &end);
+                auto n = static_cast<size_t>(end - (str.c_str() + i));
+
+                _tokens.push_back({Token::Type::NUMBER, str.substr(i, n), v, false});
+                i += n;
+
+                continue;
+
+            }
+
+            // name
+            if(std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+
+                auto j = i;
+                while(j < str.size() && (std::isalnum(static_cast<unsigned char>(str[j])) || str[j] == '_' || str[j] == '.'))
+                    ++j;
+
+                _tokens.push_back({Token::Type::NAME, str.substr(i, j - i), 0.0, false});
+                i = j;
+
+                continue;
+
+            }
+
+            // quoted name
+            if(c == '"') {
+
+                auto j = str.find('"', i + 1);
+                if(j == std::string::npos)
+                    error("missing closing quote");
+
+                _tokens.push_back({Token::Type::NAME, str.substr(i + 1, j - i - 1), 0.0, true});
+                i = j + 1;
+
+                continue;
+
+            }
+
+            // parentheses
+            if(c == '(' || c == ')') {
+                _tokens.push_back({c == '(' ? Token::Type::LPAREN : Token::Type::RPAREN, std::string(1, c), 0.0, false});
+                ++i;
+                continue;
+            }
+
+            // operators
+            static const char *ops[] = {"<=", ">=", "==", "!=", "&&", "||", "<", ">", "+", "-", "*", "/", "!"};
+
+            bool found = false;
+            for(auto op : ops) {
+
+                auto n = std::char_traits<char>::length(op);
+                if(str.compare(i, n, op) != 0)
+                    continue;
+
+                _tokens.push_back({Token::Type::OPERATOR, op, 0.0, false});
+                i += n;
+                found = true;
+
+                break;
+
+            }
+
+            if(!found)
+                error(std::string("unexpected character '") + c + "'");
+
+        }
+
+        _tokens.push_back({Token::Type::END, "end of expression", 0.0, false});
+
+    }
+
+
+    bool isKeyword(const char *keyword) const {
+
+        // quoted names are never keywords
+        auto &t = _tokens[_pos];
+        return t.type == Token::Type::NAME && !t.quoted && t.text == keyword;
+
+    }
+
+
+    bool isOperator(const char *op) const {
+
+        auto &t = _tokens[_pos];
+        return t.type == Token::Type::OPERATOR && t.text == op;
+
+    }
+
+
+    void emit(Op op, unsigned int dst, unsigned int a = 0, unsigned int b = 0, const void *ptr = nullptr,
+              double value = 0.0) {
+
+        _compiled.push_back({op, dst, a, b, ptr, value});
+
+    }
+
+
+    void binary(Op op, unsigned int r, unsigned int &registers, void (ExpressionCondition::*operand)(unsigned int, unsigned int &)) {
+
+        ++_pos;
+        (this->*operand)(r + 1, registers);
+        emit(op, r, r, r + 1);
+
+    }
+
+
+    void parseOr(unsigned int r, unsigned int &registers) {
+
+        parseAnd(r, registers);
+
+        while(isKeyword("or") || isOperator("||"))
+            binary(Op::OR, r, registers, &ExpressionCondition::parseAnd);
+
+    }
+
+
+    void parseAnd(unsigned int r, unsigned int &registers) {
+
+        parseNot(r, registers);
+
+        while(isKeyword("and") || isOperator("&&"))
+            binary(Op::AND, r, registers, &ExpressionCondition::parseNot);
+
+    }
+
+
+    void parseNot(unsigned int r, unsigned int &registers) {
+
+        if(isKeyword("not") || isOperator("!")) {
+
+            ++_pos;
+            parseNot(r, registers);
+            emit(Op::NOT, r, r);
+
+            return;
+
+        }
+
+        parseComparison(r, registers);
+
+    }
+
+
+    void parseComparison(unsigned int r, unsigned int &registers) {
+
+        parseSum(r, registers);
+
+        static const std::pair<const char *, Op> ops[] = {{"<", Op::LT}, {"<=", Op::LE}, {">", Op::GT},
+                                                          {">=", Op::GE}, {"==", Op::EQ}, {"!=", Op::NE}};
+
+        for(auto &op : ops) {
+            if(isOperator(op.first)) {
+                binary(op.second, r, registers, &ExpressionCondition::parseSum);
+                return;
+            }
+        }
+
+    }
+
+
+    void parseSum(unsigned int r, unsigned int &registers) {
+
+        parseProduct(r, registers);
+
+        while(isOperator("+") || isOperator("-"))
+            binary(isOperator("+") ? Op::ADD : Op::SUB, r, registers, &ExpressionCondition::parseProduct);
+
+    }
+
+
+    void parseProduct(unsigned int r, unsigned int &registers) {
+
+        parseUnary(r, registers);
+
+        while(isOperator("*") || isOperator("/"))
+            binary(isOperator("*") ? Op::MUL : Op::DIV, r, registers, &ExpressionCondition::parseUnary);
+
+    }
+
+
+    void parseUnary(unsigned int r, unsigned int &registers) {
+
+        if(isOperator("-")) {
+
+            ++_pos;
+            parseUnary(r, registers);
+            emit(Op::NEG, r, r);
+
+            return;
+
+        }
+
+        parsePrimary(r, registers);
+
+    }
+
+
+    void parsePrimary(unsigned int r, unsigned int &registers) {
+
+        registers = std::max(registers, r + 1);
+
+        auto &t = _tokens[_pos];
+
+        // parentheses
+        if(t.type == Token::Type::LPAREN) {
+
+            ++_pos;
+            parseOr(r, registers);
+
+            if(_tokens[_pos].type != Token::Type::RPAREN)
+                error("missing ')'");
+
+            ++_pos;
+            return;
+
+        }
+
+        // number
+        if(t.type == Token::Type::NUMBER) {
+            emit(Op::CONST, r, 0, 0, nullptr, t.number);
+            ++_pos;
+            return;
+        }
+
+        if(t.type != Token::Type::NAME)
+            error("unexpected '" + t.text + "'");
+
+        // constants
+        if(isKeyword("true") || isKeyword("false")) {
+            emit(Op::CONST, r, 0, 0, nullptr, isKeyword("true") ? 1.0 : 0.0);
+            ++_pos;
+            return;
+        }
+
+        // resolve name
+        if(!_registry->has(t.text))
+            error("unknown name '" + t.text + "'");
+
+        auto &entry = _registry->entries().at(t.text);
+
+        Op op;
+        switch(sim::data::dataTypeOf(entry.type)) {
+            case sim::data::DataType::BOOL:   op = Op::LOAD_BOOL; break;
+            case sim::data::DataType::INT:    op = Op::LOAD_INT; break;
+            case sim::data::DataType::UINT:   op = Op::LOAD_UINT; break;
+            case sim::data::DataType::LONG:   op = Op::LOAD_LONG; break;
+            case sim::data::DataType::ULONG:  op = Op::LOAD_ULONG; break;
+            case sim::data::DataType::LLONG:  op = Op::LOAD_LLONG; break;
+            case sim::data::DataType::ULLONG: op = Op::LOAD_ULLONG; break;
+            case sim::data::DataType::FLOAT:  op = Op::LOAD_FLOAT; break;
+            case sim::data::DataType::DOUBLE: op = Op::LOAD_DOUBLE; break;
+            default: error("'" + t.text + "' is not numeric");
+        }
+
+        emit(op, r, 0, 0, entry.ptr);
+        ++_pos;
+
+    }
+
+};
+
+
+#endif //SIMCORE_EXPRESSIONCONDITION_H
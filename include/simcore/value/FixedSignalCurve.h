@@ -0,0 +1,213 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_FIXEDSIGNALCURVE_H
+#define SIMCORE_FIXEDSIGNALCURVE_H
+
+#include <array>
+#include "SignalCurve.h"
+
+/**
+ * A signal curve with a fixed number of points, which can be defined and evaluated at compile time. The semantics
+ * of interpolate(), previous(), next() and where() equal the semantics of SignalCurve. When a curve is defined in a
+ * constant expression, invalid definitions and lookups out of bounds are compile errors
+ * @tparam N Number of points
+ */
+template<size_t N>
+class FixedSignalCurve {
+
+    static_assert(N > 1, "a curve needs at least two points");
+
+    std::array<double, N> _x;
+    std::array<double, N> _y;
+
+
+public:
+
+
+    typedef SignalCurve::Position Position;
+
+
+    /**
+     * Define the curve. The x-values must be strictly monotonous
+     * @param x x-values
+     * @param y y-values
+     */
+    constexpr FixedSignalCurve(const std::array<double, N> &x, const std::array<double, N> &y) : _x(x), _y(y) {
+
+        for(size_t i = 1; i < N; ++i) {
+            if(!(x[i - 1] < x[i]))
+                throw std::invalid_argument("interpolation only possible with strictly monotonous data");
+        }
+
+    }
+
+
+    /**
+     * Check if the value is within defined boundaries
+     * @param x Value to be checked
+     * @return Flag if the value is in bounds
+     */
+    constexpr bool isInBounds(double x) const {
+
+        return x >= _x[0] && x <= _x[N - 1];
+
+    }
+
+
+    /**
+     * Calculates the y-value at the given x point by linear interpolation
+     * @param x x-value
+     * @return y-value
+     */
+    constexpr double interpolate(double x) const {
+
+        // check if x is out of bounds
+        if(x < _x[0] - EPS_DISTANCE || x > _x[N - 1] + EPS_DISTANCE)
+            throw std::invalid_argument("x out of bounds");
+
+        auto w = where(x);
+        return w.v0 - w.ds0 * (w.v1 - w.v0) / (w.ds1 - w.ds0);
+
+    }
+
+
+    /**
+     * Returns the previous value
+     * @param x x-value
+     * @return y-value
+     */
+    constexpr double previous(double x) const {
+
+        // check if x is out of bounds
+        if(x < _x[0] - EPS_DISTANCE)
+            throw std::invalid_argument("x out of bounds");
+
+        auto w = where(x);
+
+        if(w.ds1 <= 0.0)
+            return w.v1;
+        else
+            return w.v0;
+
+    }
+
+
+    /**
+     * Returns the next value
+     * @param x x-value
+     * @return y-value
+     */
+    constexpr double next(double x) const {
+
+        // check if x is out of bounds
+        if(x > _x[N - 1] + EPS_DISTANCE)
+            throw std::invalid_argument("x out of bounds");
+
+        auto w = where(x);
+
+        if(w.ds0 > 0.0)
+            return w.v0;
+        else
+            return w.v1;
+
+    }
+
+
+    /**
+     * Returns the previous and the next value at the given point. If the value is out of bounds, the closest
+     * values are taken. The distances are given relative to the given position
+     * @param x x-Position
+     * @return Structure of positions and values
+     */
+    constexpr Position where(double x) const {
+
+        // binary search for the segment [x_i, x_i+1), out of bounds values are assigned to the first or last segment
+        size_t lo = 0;
+        size_t hi = N - 2;
+
+        while(lo < hi) {
+
+            auto mid = (lo + hi + 1) / 2;
+
+            if(_x[mid] <= x)
+                lo = mid;
+            else
+                hi = mid - 1;
+
+        }
+
+        return {_x[lo] - x, _y[lo], _x[lo + 1] - x, _y[lo + 1]};
+
+    }
+
+
+    /**
+     * Calculates if the data point hit the signal curve
+     * @param x x-value
+     * @param y y-value
+     * @param eps Tolerance (in y-direction, half band width)
+     * @return Flag
+     */
+    constexpr bool hit(double x, double y, double eps = EPS_DISTANCE) const {
+
+        auto d = interpolate(x) - y;
+        return (d < 0.0 ? -d : d) < eps;
+
+    }
+
+
+    /**
+     * Returns the number of points
+     * @return Number of points
+     */
+    static constexpr size_t size() {
+
+        return N;
+
+    }
+
+};
+
+
+/**
+ * Creates a fixed signal curve from two arrays of equal size, e.g. makeFixedSignalCurve({0.0, 1.0}, {2.0, 3.0})
+ * @tparam N Number of points
+ * @param x x-values
+ * @param y y-values
+ * @return Curve
+ */
+template<size_t N>
+constexpr FixedSignalCurve<N> makeFixedSignalCurve(const double (&x)[N], const double (&y)[N]) {
+
+    std::array<double, N> ax{}, ay{};
+    for(size_t i = 0; i < N; ++i) {
+        ax[i] = x[i];
+        ay[i] = y[i];
+    }
+
+    return FixedSignalCurve<N>(ax, ay);
+
+}
+
+
+#endif //SIMCORE_FIXEDSIGNALCURVE_H
@@ -31,13 +31,33 @@
 
 #include <vector>
 #include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <cmath>
 
 class SignalCurve {
 
+public:
+
+    /**
+     * Interpolation modes
+     */
+    enum class Interpolation {
+        LINEAR,       //!< piecewise linear
+        CUBIC_SPLINE, //!< natural cubic spline (continuous second derivative, zero at the ends)
+        PCHIP         //!< piecewise cubic hermite (monotone between the points, no overshoot)
+    };
+
+
+private:
+
     std::vector<double> _x;
     std::vector<double> _y;
 
+    Interpolation _mode = Interpolation::LINEAR;
+    std::vector<double> _c{}; // cubic coefficients, four per segment: y = c0 + c1 t + c2 t^2 + c3 t^3, t = x - x_i
+
 
 public:
 
@@ -50,21 +70,204 @@ public:
     };
 
 
+    /**
+     * A hint for consecutive lookups. When the queried x values increase (e.g. with the simulation time), the
+     * segment is found in amortized constant time. A cursor can be used with any curve, it must not be shared
+     * between threads
+     */
+    struct Cursor {
+        size_t segment = 0;
+    };
+
+
     SignalCurve() = default;
     ~SignalCurve() = default;
 
     /**
-     * Define the curve
+     * Define the curve. The x-values must be strictly monotonous. For the cubic modes, the coefficients of all
+     * segments are calculated once
      * @param x x-values
      * @param y y-values
+     * @param mode Interpolation mode
      */
-    void define(std::vector<double> &&x, std::vector<double> &&y) {
+    void define(std::vector<double> &&x, std::vector<double> &&y, Interpolation mode = Interpolation::LINEAR) {
 
         if(x.size() != y.size())
             throw std::invalid_argument("sizes must be equal");
 
+        for(size_t i = 1; i < x.size(); ++i) {
+            if(!(x[i - 1] < x[i]))
+                throw std::invalid_argument("interpolation only possible with strictly monotonous data");
+        }
+
         _x = std::move(x);
         _y = std::move(y);
+        _mode = mode;
+
+        // calculate coefficients
+        _c.clear();
+        if(_mode == Interpolation::CUBIC_SPLINE)
+            calculateSpline();
+        else if(_mode == Interpolation::PCHIP)
+            calculatePchip();
+
+    }
+
+
+    /**
+     * Removes points by the Douglas-Peucker algorithm, as long as the piecewise linear curve through the remaining
+     * points deviates from the original points by not more than the tolerance (in y-direction). The first and the
+     * last point are kept. For the cubic modes, the coefficients are recalculated and the refit curve is checked at
+     * the removed points. In each segment exceeding the tolerance, the point with the largest deviation is added
+     * again, until the refit curve is within the tolerance
+     * @param tolerance Maximum deviation in y-direction
+     * @return Maximum deviation of the resulting curve at the removed points
+     */
+    double simplify(double tolerance) {
+
+        if(tolerance < 0.0)
+            throw std::invalid_argument("tolerance must not be negative");
+
+        auto n = _x.size();
+        if(n < 3)
+            return 0.0;
+
+        // original points
+        auto x0 = std::move(_x);
+        auto y0 = std::move(_y);
+
+        std::vector<char> keep(n, 0);
+        keep[0] = keep[n - 1] = 1;
+
+        // split segments iteratively
+        std::vector<std::pair<size_t, size_t>> stack{{0, n - 1}};
+        double deviation = 0.0;
+
+        while(!stack.empty()) {
+
+            auto a = stack.back().first;
+            auto b = stack.back().second;
+            stack.pop_back();
+
+            if(b - a < 2)
+                continue;
+
+            // find point with the largest deviation from the chord
+            auto slope = (y0[b] - y0[a]) / (x0[b] - x0[a]);
+            double dMax = -1.0;
+            size_t iMax = a;
+
+            for(auto i = a + 1; i < b; ++i) {
+
+                auto d = std::fabs(y0[i] - (y0[a] + (x0[i] - x0[a]) * slope));
+
+                if(d > dMax) {
+                    dMax = d;
+                    iMax = i;
+                }
+
+            }
+
+            // keep the point or accept the chord
+            if(dMax > tolerance) {
+                keep[iMax] = 1;
+                stack.emplace_back(a, iMax);
+                stack.emplace_back(iMax, b);
+            } else {
+                deviation = std::max(deviation, dMax);
+            }
+
+        }
+
+        while(true) {
+
+            // take the remaining points and recalculate coefficients
+            _x.clear();
+            _y.clear();
+            for(size_t i = 0; i < n; ++i) {
+
+                if(!keep[i])
+                    continue;
+
+                _x.push_back(x0[i]);
+                _y.push_back(y0[i]);
+
+            }
+
+            _c.clear();
+            if(_mode == Interpolation::CUBIC_SPLINE)
+                calculateSpline();
+            else if(_mode == Interpolation::PCHIP)
+                calculatePchip();
+            else
+                break; // the chords are the curve
+
+            // check the refit curve at the removed points
+            auto refined = false;
+            double dMax = -1.0;
+            size_t iMax = 0;
+            size_t k = 0;
+            deviation = 0.0;
+
+            for(size_t i = 1; i < n; ++i) {
+
+                // end of segment: keep the worst point, if the tolerance is exceeded
+                if(keep[i]) {
+
+                    if(dMax > tolerance) {
+                        keep[iMax] = 1;
+                        refined = true;
+                    } else {
+                        deviation = std::max(deviation, dMax);
+                    }
+
+                    dMax = -1.0;
+                    ++k;
+
+                    continue;
+
+                }
+
+                auto d = std::fabs(y0[i] - evaluate(k, x0[i]));
+
+                if(d > dMax) {
+                    dMax = d;
+                    iMax = i;
+                }
+
+            }
+
+            if(!refined)
+                break;
+
+        }
+
+        _x.shrink_to_fit();
+        _y.shrink_to_fit();
+
+        return deviation;
+
+    }
+
+
+    /**
+     * Returns the number of points
+     * @return Number of points
+     */
+    size_t size() const {
+
+        return _x.size();
+
+    }
+
+
+    /**
+     * Returns the interpolation mode
+     * @return Interpolation mode
+     */
+    Interpolation interpolation() const {
+
+        return _mode;
 
     }
 
@@ -82,7 +285,7 @@ public:
 
 
     /**
-     * Calculates the y-value at the given x point by linear interpolation
+     * Calculates the y-value at the given x point by interpolation
      * @param x x-value
      * @return y-value
      */
@@ -92,8 +295,164 @@ public:
         if(x < _x.front() - EPS_DISTANCE || x > _x.back() + EPS_DISTANCE)
             throw std::invalid_argument("x out of bounds");
 
-        auto w = where(x);
-        return w.v0 - w.ds0 * (w.v1 - w.v0) / (w.ds1 - w.ds0);
+        return evaluate(segment(x), x);
+
+    }
+
+
+    /**
+     * Calculates the first derivative dy/dx at the given x point. For linear interpolation, the slope of the segment
+     * is returned (at the points: the slope of the following segment)
+     * @param x x-value
+     * @return First derivative
+     */
+    double derivative(double x) const {
+
+        // check if x is out of bounds
+        if(x < _x.front() - EPS_DISTANCE || x > _x.back() + EPS_DISTANCE)
+            throw std::invalid_argument("x out of bounds");
+
+        auto k = segment(x);
+
+        if(_mode == Interpolation::LINEAR)
+            return (_y[k + 1] - _y[k]) / (_x[k + 1] - _x[k]);
+
+        auto c = &_c[4 * k];
+        auto t = x - _x[k];
+
+        return c[1] + t * (2.0 * c[2] + t * 3.0 * c[3]);
+
+    }
+
+
+    /**
+     * Calculates the second derivative d2y/dx2 at the given x point. For linear interpolation, zero is returned
+     * @param x x-value
+     * @return Second derivative
+     */
+    double secondDerivative(double x) const {
+
+        // check if x is out of bounds
+        if(x < _x.front() - EPS_DISTANCE || x > _x.back() + EPS_DISTANCE)
+            throw std::invalid_argument("x out of bounds");
+
+        if(_mode == Interpolation::LINEAR)
+            return 0.0;
+
+        auto k = segment(x);
+        auto c = &_c[4 * k];
+
+        return 2.0 * c[2] + 6.0 * c[3] * (x - _x[k]);
+
+    }
+
+
+    /**
+     * Calculates the y-value at the given x point by interpolation, starting the lookup at the cursor
+     * @param x x-value
+     * @param cursor Lookup hint, updated to the segment of x
+     * @return y-value
+     */
+    double interpolate(double x, Cursor &cursor) const {
+
+        // check if x is out of bounds
+        if(x < _x.front() - EPS_DISTANCE || x > _x.back() + EPS_DISTANCE)
+            throw std::invalid_argument("x out of bounds");
+
+        return evaluate(segment(x, cursor), x);
+
+    }
+
+
+    /**
+     * Calculates the y-values at the given x points by interpolation. Sorted inputs are located in a single
+     * merge pass, unsorted inputs by binary search. Instead of throwing, points out of bounds are set to NaN and
+     * flagged in the bit mask (bit i % 64 of word i / 64)
+     * @param xs x-values
+     * @param ys y-values (output, n elements)
+     * @param n Number of points
+     * @param outOfBounds Bit mask of the points out of bounds (output, resized to fit n bits)
+     * @return Number of points out of bounds
+     */
+    size_t interpolate(const double *xs, double *ys, size_t n, std::vector<std::uint64_t> &outOfBounds) const {
+
+        constexpr size_t block = 256;
+
+        outOfBounds.assign((n + 63) / 64, 0);
+
+        auto lo = _x.front() - EPS_DISTANCE;
+        auto hi = _x.back() + EPS_DISTANCE;
+        auto sorted = std::is_sorted(xs, xs + n);
+
+        size_t seg[block];
+        size_t count = 0;
+        size_t j = 0;
+
+        for(size_t b = 0; b < n; b += block) {
+
+            auto m = std::min(block, n - b);
+            auto x = xs + b;
+            auto y = ys + b;
+
+            // locate segments
+            if(sorted) {
+
+                auto last = _x.size() - 2;
+                for(size_t i = 0; i < m; ++i) {
+
+                    while(j < last && _x[j + 1] <= x[i])
+                        ++j;
+
+                    seg[i] = j;
+
+                }
+
+            } else {
+
+                for(size_t i = 0; i < m; ++i)
+                    seg[i] = segment(x[i]);
+
+            }
+
+            // interpolate (no branches, vectorizable)
+            if(_mode == Interpolation::LINEAR) {
+
+                for(size_t i = 0; i < m; ++i) {
+
+                    auto k = seg[i];
+                    auto ds0 = _x[k] - x[i];
+                    auto ds1 = _x[k + 1] - x[i];
+                    y[i] = _y[k] - ds0 * (_y[k + 1] - _y[k]) / (ds1 - ds0);
+
+                }
+
+            } else {
+
+                for(size_t i = 0; i < m; ++i) {
+
+                    auto c = &_c[4 * seg[i]];
+                    auto t = x[i] - _x[seg[i]];
+                    y[i] = c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+
+                }
+
+            }
+
+            // flag points out of bounds
+            for(size_t i = 0; i < m; ++i) {
+
+                if(x[i] >= lo && x[i] <= hi)
+                    continue;
+
+                y[i] = std::numeric_limits<double>::quiet_NaN();
+                outOfBounds[(b + i) / 64] |= std::uint64_t(1) << ((b + i) % 64);
+                ++count;
+
+            }
+
+        }
+
+        return count;
 
     }
 
@@ -148,30 +507,22 @@ public:
      */
     Position where(double x) const {
 
-        auto n = _x.size();
-
-        // check boundaries
-        if(x <= _x[0])
-            return {_x[0] - x, _y[0], _x[1] - x, _y[1]};
-
-        else if(x >= _x[n - 1])
-            return {_x[n - 2] - x, _y[n - 2], _x[n - 1] - x, _y[n - 1]};
-
-
-        unsigned int i;
-        for(i = 1; i < _x.size(); ++i) {
+        auto i = segment(x);
+        return {_x[i] - x, _y[i], _x[i + 1] - x, _y[i + 1]};
 
-            // check for strictly monotonous
-            if(_x[i - 1] >= _x[i])
-                throw std::runtime_error("interpolation only possible with strictly monotonous data");
+    }
 
-            // interpolate if in bounds
-            if (_x[i] > x)
-                return {_x[i - 1] - x, _y[i - 1], _x[i] - x, _y[i]};
 
-        }
+    /**
+     * Returns the previous and the next value at the given point like where(x), starting the lookup at the cursor
+     * @param x x-Position
+     * @param cursor Lookup hint, updated to the segment of x
+     * @return Structure of positions and values
+     */
+    Position where(double x, Cursor &cursor) const {
 
-        return {};
+        auto i = segment(x, cursor);
+        return {_x[i] - x, _y[i], _x[i + 1] - x, _y[i + 1]};
 
     }
 
@@ -200,6 +551,204 @@ public:
 
     }
 
+
+private:
+
+
+    /**
+     * Evaluates the curve in the given segment
+     * @param k Segment index
+     * @param x x-value
+     * @return y-value
+     */
+    double evaluate(size_t k, double x) const {
+
+        if(_mode == Interpolation::LINEAR) {
+
+            auto ds0 = _x[k] - x;
+            auto ds1 = _x[k + 1] - x;
+
+            return _y[k] - ds0 * (_y[k + 1] - _y[k]) / (ds1 - ds0);
+
+        }
+
+        auto c = &_c[4 * k];
+        auto t = x - _x[k];
+
+        return c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+
+    }
+
+
+    /**
+     * Sets the coefficients of a segment from the values and the first derivatives at both ends
+     * @param k Segment index
+     * @param d0 First derivative at x_k
+     * @param d1 First derivative at x_k+1
+     */
+    void setHermite(size_t k, double d0, double d1) {
+
+        auto h = _x[k + 1] - _x[k];
+        auto delta = (_y[k + 1] - _y[k]) / h;
+
+        _c[4 * k]     = _y[k];
+        _c[4 * k + 1] = d0;
+        _c[4 * k + 2] = (3.0 * delta - 2.0 * d0 - d1) / h;
+        _c[4 * k + 3] = (d0 + d1 - 2.0 * delta) / (h * h);
+
+    }
+
+
+    /**
+     * Calculates the coefficients of the natural cubic spline by solving the tridiagonal system of the second
+     * derivatives (Thomas algorithm)
+     */
+    void calculateSpline() {
+
+        auto n = _x.size();
+        if(n < 2)
+            return;
+
+        _c.assign(4 * (n - 1), 0.0);
+
+        // second derivatives, zero at the ends
+        std::vector<double> m(n, 0.0), cp(n, 0.0), dp(n, 0.0);
+
+        for(size_t i = 1; i + 1 < n; ++i) {
+
+            auto h0 = _x[i] - _x[i - 1];
+            auto h1 = _x[i + 1] - _x[i];
+            auto r = 6.0 * ((_y[i + 1] - _y[i]) / h1 - (_y[i] - _y[i - 1]) / h0);
+
+            auto den = 2.0 * (h0 + h1) - h0 * cp[i - 1];
+            cp[i] = h1 / den;
+            dp[i] = (r - h0 * dp[i - 1]) / den;
+
+        }
+
+        for(size_t i = n - 2; i > 0; --i)
+            m[i] = dp[i] - cp[i] * m[i + 1];
+
+        // coefficients
+        for(size_t k = 0; k + 1 < n; ++k) {
+
+            auto h = _x[k + 1] - _x[k];
+
+            _c[4 * k]     = _y[k];
+            _c[4 * k + 1] = (_y[k + 1] - _y[k]) / h - h * (2.0 * m[k] + m[k + 1]) / 6.0;
+            _c[4 * k + 2] = 0.5 * m[k];
+            _c[4 * k + 3] = (m[k + 1] - m[k]) / (6.0 * h);
+
+        }
+
+    }
+
+
+    /**
+     * Calculates the coefficients of the monotone piecewise cubic hermite interpolation (Fritsch-Carlson slopes with
+     * weighted harmonic means, shape preserving three-point slopes at the ends)
+     */
+    void calculatePchip() {
+
+        auto n = _x.size();
+        if(n < 2)
+            return;
+
+        _c.assign(4 * (n - 1), 0.0);
+
+        // secants
+        std::vector<double> h(n - 1), delta(n - 1), d(n, 0.0);
+        for(size_t k = 0; k + 1 < n; ++k) {
+            h[k] = _x[k + 1] - _x[k];
+            delta[k] = (_y[k + 1] - _y[k]) / h[k];
+        }
+
+        if(n == 2) {
+            setHermite(0, delta[0], delta[0]);
+            return;
+        }
+
+        // interior slopes
+        for(size_t k = 1; k + 1 < n; ++k) {
+
+            if(delta[k - 1] * delta[k] <= 0.0)
+                continue;
+
+            auto w1 = 2.0 * h[k] + h[k - 1];
+            auto w2 = h[k] + 2.0 * h[k - 1];
+            d[k] = (w1 + w2) / (w1 / delta[k - 1] + w2 / delta[k]);
+
+        }
+
+        // end slopes
+        auto edge = [] (double h0, double h1, double m0, double m1) {
+
+            auto s = ((2.0 * h0 + h1) * m0 - h0 * m1) / (h0 + h1);
+
+            if(s * m0 <= 0.0)
+                return 0.0;
+            else if(m0 * m1 < 0.0 && std::fabs(s) > 3.0 * std::fabs(m0))
+                return 3.0 * m0;
+
+            return s;
+
+        };
+
+        d[0] = edge(h[0], h[1], delta[0], delta[1]);
+        d[n - 1] = edge(h[n - 2], h[n - 3], delta[n - 2], delta[n - 3]);
+
+        for(size_t k = 0; k + 1 < n; ++k)
+            setHermite(k, d[k], d[k + 1]);
+
+    }
+
+
+    /**
+     * Returns the index of the segment [x_i, x_i+1) containing x by binary search. Values out of bounds are
+     * assigned to the first or the last segment
+     * @param x x-value
+     * @return Index of the first point of the segment
+     */
+    size_t segment(double x) const {
+
+        auto it = std::upper_bound(_x.begin() + 1, _x.end() - 1, x);
+        return static_cast<size_t>(it - _x.begin()) - 1;
+
+    }
+
+
+    /**
+     * Returns the index of the segment containing x. The cursor segment and the next segments are checked first,
+     * binary search is used for larger steps and steps backwards
+     * @param x x-value
+     * @param cursor Lookup hint, updated to the found segment
+     * @return Index of the first point of the segment
+     */
+    size_t segment(double x, Cursor &cursor) const {
+
+        auto last = _x.size() - 2;
+        auto i = std::min(cursor.segment, last);
+
+        if(i == 0 || _x[i] <= x) {
+
+            // walk forward a few segments
+            for(unsigned int k = 0; k < 4 && i < last && _x[i + 1] <= x; ++k)
+                ++i;
+
+            if(i < last && _x[i + 1] <= x)
+                i = segment(x);
+
+        } else {
+
+            i = segment(x);
+
+        }
+
+        cursor.segment = i;
+        return i;
+
+    }
+
 };
 
 
@@ -0,0 +1,282 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_SIGNALMAP_H
+#define SIMCORE_SIGNALMAP_H
+
+#ifndef EPS_DISTANCE
+#define EPS_DISTANCE 1e-9
+#endif
+
+#include <vector>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <cmath>
+
+/**
+ * A two-dimensional lookup table z(x, y) on a rectilinear grid with bilinear interpolation. The values are stored
+ * contiguously in row-major order, i.e. z[i * ny + j] is the value at (x_i, y_j)
+ */
+class SignalMap {
+
+    std::vector<double> _x;
+    std::vector<double> _y;
+    std::vector<double> _z;
+
+
+public:
+
+
+    /**
+     * A hint for consecutive lookups. When the inputs change slowly, the cell is found in constant time. A cursor
+     * must not be shared between threads
+     */
+    struct Cursor {
+        size_t i = 0;
+        size_t j = 0;
+    };
+
+
+    SignalMap() = default;
+    ~SignalMap() = default;
+
+    /**
+     * Define the map. Both axes must be strictly monotonous with at least two points
+     * @param x x-axis (rows)
+     * @param y y-axis (columns)
+     * @param z Values in row-major order (x.size() * y.size() elements)
+     */
+    void define(std::vector<double> &&x, std::vector<double> &&y, std::vector<double> &&z) {
+
+        if(x.size() < 2 || y.size() < 2)
+            throw std::invalid_argument("axes must have at least two points");
+
+        if(z.size() != x.size() * y.size())
+            throw std::invalid_argument("size of values must be the product of the axis sizes");
+
+        for(auto axis : {&x, &y}) {
+            for(size_t i = 1; i < axis->size(); ++i) {
+                if(!((*axis)[i - 1] < (*axis)[i]))
+                    throw std::invalid_argument("interpolation only possible with strictly monotonous data");
+            }
+        }
+
+        _x = std::move(x);
+        _y = std::move(y);
+        _z = std::move(z);
+
+    }
+
+
+    /**
+     * Check if the point is within defined boundaries
+     * @param x x-value
+     * @param y y-value
+     * @return Flag if the point is in bounds
+     */
+    bool isInBounds(double x, double y) const {
+
+        return x >= _x.front() && x <= _x.back() && y >= _y.front() && y <= _y.back();
+
+    }
+
+
+    /**
+     * Calculates the value at the given point by bilinear interpolation
+     * @param x x-value
+     * @param y y-value
+     * @return z-value
+     */
+    double interpolate(double x, double y) const {
+
+        check(x, y);
+        return evaluate(segment(_x, x), segment(_y, y), x, y);
+
+    }
+
+
+    /**
+     * Calculates the value at the given point by bilinear interpolation, starting the lookup at the cursor
+     * @param x x-value
+     * @param y y-value
+     * @param cursor Lookup hint, updated to the cell of the point
+     * @return z-value
+     */
+    double interpolate(double x, double y, Cursor &cursor) const {
+
+        check(x, y);
+
+        cursor.i = segment(_x, x, cursor.i);
+        cursor.j = segment(_y, y, cursor.j);
+
+        return evaluate(cursor.i, cursor.j, x, y);
+
+    }
+
+
+    /**
+     * Calculates the values at the given points by bilinear interpolation. The cells are located by walking from the
+     * cell of the previous point. Instead of throwing, points out of bounds are set to NaN and flagged in the bit
+     * mask (bit i % 64 of word i / 64)
+     * @param xs x-values
+     * @param ys y-values
+     * @param zs z-values (output, n elements)
+     * @param n Number of points
+     * @param outOfBounds Bit mask of the points out of bounds (output, resized to fit n bits)
+     * @return Number of points out of bounds
+     */
+    size_t interpolate(const double *xs, const double *ys, double *zs, size_t n,
+                       std::vector<std::uint64_t> &outOfBounds) const {
+
+        constexpr size_t block = 256;
+
+        outOfBounds.assign((n + 63) / 64, 0);
+
+        size_t ci[block], cj[block];
+        size_t count = 0;
+        Cursor cursor;
+
+        for(size_t b = 0; b < n; b += block) {
+
+            auto m = std::min(block, n - b);
+            auto x = xs + b;
+            auto y = ys + b;
+            auto z = zs + b;
+
+            // locate cells
+            for(size_t k = 0; k < m; ++k) {
+                ci[k] = cursor.i = segment(_x, x[k], cursor.i);
+                cj[k] = cursor.j = segment(_y, y[k], cursor.j);
+            }
+
+            // interpolate
+            for(size_t k = 0; k < m; ++k)
+                z[k] = evaluate(ci[k], cj[k], x[k], y[k]);
+
+            // flag points out of bounds
+            for(size_t k = 0; k < m; ++k) {
+
+                if(x[k] >= _x.front() - EPS_DISTANCE && x[k] <= _x.back() + EPS_DISTANCE
+                   && y[k] >= _y.front() - EPS_DISTANCE && y[k] <= _y.back() + EPS_DISTANCE)
+                    continue;
+
+                z[k] = std::numeric_limits<double>::quiet_NaN();
+                outOfBounds[(b + k) / 64] |= std::uint64_t(1) << ((b + k) % 64);
+                ++count;
+
+            }
+
+        }
+
+        return count;
+
+    }
+
+
+    /**
+     * Checks if the map is set
+     * @return true if the map is defined
+     */
+    bool isSet() const {
+
+        return _x.size() > 1 && _y.size() > 1;
+
+    }
+
+
+private:
+
+
+    void check(double x, double y) const {
+
+        // check if x is out of bounds
+        if(x < _x.front() - EPS_DISTANCE || x > _x.back() + EPS_DISTANCE)
+            throw std::invalid_argument("x out of bounds");
+
+        // check if y is out of bounds
+        if(y < _y.front() - EPS_DISTANCE || y > _y.back() + EPS_DISTANCE)
+            throw std::invalid_argument("y out of bounds");
+
+    }
+
+
+    double evaluate(size_t i, size_t j, double x, double y) const {
+
+        auto ny = _y.size();
+        auto z = &_z[i * ny + j];
+
+        auto u = (x - _x[i]) / (_x[i + 1] - _x[i]);
+        auto v = (y - _y[j]) / (_y[j + 1] - _y[j]);
+
+        auto z0 = z[0] + v * (z[1] - z[0]);
+        auto z1 = z[ny] + v * (z[ny + 1] - z[ny]);
+
+        return z0 + u * (z1 - z0);
+
+    }
+
+
+    /**
+     * Returns the index of the segment [a_i, a_i+1) containing v by binary search. Values out of bounds are
+     * assigned to the first or the last segment
+     */
+    static size_t segment(const std::vector<double> &a, double v) {
+
+        auto it = std::upper_bound(a.begin() + 1, a.end() - 1, v);
+        return static_cast<size_t>(it - a.begin()) - 1;
+
+    }
+
+
+    /**
+     * Returns the index of the segment containing v. The hinted segment and its neighbours are checked first,
+     * binary search is used for larger steps
+     */
+    static size_t segment(const std::vector<double> &a, double v, size_t hint) {
+
+        auto last = a.size() - 2;
+        auto i = std::min(hint, last);
+
+        for(unsigned int k = 0; k < 2; ++k) {
+
+            if(i < last && a[i + 1] <= v)
+                ++i;
+            else if(i > 0 && v < a[i])
+                --i;
+            else
+                return i;
+
+        }
+
+        if((i < last && a[i + 1] <= v) || (i > 0 && v < a[i]))
+            return segment(a, v);
+
+        return i;
+
+    }
+
+};
+
+
+#endif //SIMCORE_SIGNALMAP_H
@@ -25,17 +25,45 @@
 #ifndef SIMCORE_SIGNALTUBE_H
 #define SIMCORE_SIGNALTUBE_H
 
+#include <utility>
 #include "SignalCurve.h"
+#include "UniformSignalCurve.h"
 
-class SignalTube {
+/**
+ * A band between a lower and an upper curve
+ * @tparam Curve Curve type (SignalCurve or UniformSignalCurve)
+ */
+template<class Curve>
+class BasicSignalTube {
 
-    SignalCurve upper{};
-    SignalCurve lower{};
+    Curve upper{};
+    Curve lower{};
 
 public:
 
 
-    SignalTube() = default;
+    /**
+     * Lookup hints for the lower and the upper curve
+     */
+    struct Cursor {
+        typename Curve::Cursor lower{};
+        typename Curve::Cursor upper{};
+    };
+
+
+    /**
+     * Result of the evaluation of a trajectory
+     */
+    struct Evaluation {
+        std::vector<std::uint64_t> out{}; //!< bit mask of the points outside the tube (bit i % 64 of word i / 64)
+        std::vector<double> lowerMargin{}; //!< y - lower(x), NaN if x is out of the bounds of the lower curve
+        std::vector<double> upperMargin{}; //!< upper(x) - y, NaN if x is out of the bounds of the upper curve
+        size_t violations = 0;             //!< number of points outside the tube
+        size_t firstViolation = 0;         //!< index of the first point outside the tube (number of points if none)
+    };
+
+
+    BasicSignalTube() = default;
 
 
     /**
@@ -62,6 +90,20 @@ public:
     }
 
 
+    /**
+     * Simplifies both curves (see SignalCurve::simplify). Only available for curves, which can be simplified (not for
+     * UniformSignalCurve, which keeps the uniform grid)
+     * @param tolerance Maximum deviation in y-direction
+     * @return Maximum deviation introduced
+     */
+    template<class C = Curve>
+    auto simplify(double tolerance) -> decltype(std::declval<C&>().simplify(tolerance)) {
+
+        return std::max(lower.simplify(tolerance), upper.simplify(tolerance));
+
+    }
+
+
     /**
      * Returns the center value between the upper and the lower curve at the given position
      * @param x Position
@@ -95,6 +137,85 @@ public:
     }
 
 
+    /**
+     * Checks if the value is within the band, starting the lookups at the cursor
+     * @param x x-value
+     * @param y y-value
+     * @param cursor Lookup hints, updated to the segments of x
+     * @return true when the value is within the band
+     */
+    bool in(double x, double y, Cursor &cursor) const {
+
+        bool inLow = true;
+        if(lower.isInBounds(x))
+            inLow = lower.interpolate(x, cursor.lower) <= y;
+
+        bool inUp = true;
+        if(upper.isInBounds(x))
+            inUp = y <= upper.interpolate(x, cursor.upper);
+
+        return inLow && inUp;
+
+    }
+
+
+
+    /**
+     * Evaluates a whole trajectory. Both curves are interpolated by their batch interpolation (a single merge pass
+     * for sorted x-values). A point is outside the tube, when a margin within the bounds of its curve is negative or
+     * NaN (e.g. for NaN y-values), which equals in(x, y). Margins out of bounds are NaN
+     * @param xs x-values
+     * @param ys y-values
+     * @param n Number of points
+     * @return Evaluation
+     */
+    Evaluation evaluate(const double *xs, const double *ys, size_t n) const {
+
+        Evaluation e;
+        e.lowerMargin.resize(n);
+        e.upperMargin.resize(n);
+        e.out.assign((n + 63) / 64, 0);
+
+        // interpolate curves
+        std::vector<std::uint64_t> mask;
+        lower.interpolate(xs, e.lowerMargin.data(), n, mask);
+        upper.interpolate(xs, e.upperMargin.data(), n, mask);
+
+        // margins (vectorizable)
+        auto lm = e.lowerMargin.data();
+        auto um = e.upperMargin.data();
+        for(size_t i = 0; i < n; ++i) {
+            lm[i] = ys[i] - lm[i];
+            um[i] = um[i] - ys[i];
+        }
+
+        // flag violations, no margins out of bounds
+        e.firstViolation = n;
+        for(size_t i = 0; i < n; ++i) {
+
+            auto inLow = lower.isInBounds(xs[i]);
+            auto inUp = upper.isInBounds(xs[i]);
+
+            if(!inLow)
+                lm[i] = std::numeric_limits<double>::quiet_NaN();
+
+            if(!inUp)
+                um[i] = std::numeric_limits<double>::quiet_NaN();
+
+            // (NaN margins within the bounds are violations)
+            if(!((inLow && !(lm[i] >= 0.0)) || (inUp && !(um[i] >= 0.0))))
+                continue;
+
+            e.out[i / 64] |= std::uint64_t(1) << (i % 64);
+            e.firstViolation = std::min(e.firstViolation, i);
+            e.violations++;
+
+        }
+
+        return e;
+
+    }
+
 
     /**
      * Checks if the curve is set by at least two points
@@ -120,4 +241,8 @@ public:
 
 };
 
+
+typedef BasicSignalTube<SignalCurve> SignalTube;
+typedef BasicSignalTube<UniformSignalCurve> UniformSignalTube;
+
 #endif //SIMCORE_SIGNALTUBE_H
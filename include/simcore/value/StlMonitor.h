@@ -0,0 +1,651 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_STLMONITOR_H
+#define SIMCORE_STLMONITOR_H
+
+#ifndef EPS_SIM_TIME
+#define EPS_SIM_TIME 1e-9
+#endif
+
+#include <deque>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include "../IStopCondition.h"
+#include "../IComponent.h"
+#include "../exceptions.h"
+
+/**
+ * An online monitor for signal temporal logic (STL) formulas with bounded time intervals. The formula is built from
+ * predicates over values and the operators not, and, or, always, eventually and until. It is evaluated with
+ * quantitative semantics (robustness: positive when satisfied, negative when violated).
+ *
+ * Each step, the predicates are sampled and the robustness is propagated incrementally. The temporal operators
+ * always and eventually use sliding-window minimum/maximum queues, until uses a sliding-window aggregation over two
+ * stacks and a minimum queue for phi before the interval (all amortized O(1) per step). Since the future operators
+ * need future samples, the robustness at time t is known with the delay of the formula horizon. Robustness values
+ * whose windows are not complete at the end of the simulation are not evaluated.
+ *
+ * The monitor stops the simulation when the formula is violated:
+ *  - INITIAL: the formula must hold at the first step (e.g. "eventually within 10 s")
+ *  - GLOBALLY: the formula must hold at every step (e.g. "always within the tube")
+ *
+ * The event of the stop holds the time, for which the formula was violated, and the robustness at this time.
+ */
+class StlMonitor : public ::sim::IStopCondition, public ::sim::IComponent {
+
+public:
+
+    typedef IStopCondition::StopCode Mode;
+    typedef size_t Formula;
+
+    enum class Semantics { INITIAL, GLOBALLY };
+
+
+private:
+
+    enum class Type { PREDICATE, NOT, AND, OR, EVENTUALLY, UNTIL };
+
+    struct Sample {
+        double t;
+        double v;
+    };
+
+    struct Pair {
+        double t;
+        double phi;
+        double psi;
+    };
+
+    // summary of consecutive samples for until: minimum of phi and max over t' of min(psi(t'), min of phi up to t')
+    struct Span {
+        double phi;
+        double value;
+    };
+
+    struct Entry {
+        Pair p;
+        Span span; // front stack: span of the entry and all newer entries in the stack
+    };
+
+    struct Node {
+
+        Type type;
+        size_t a = 0;               // first operand
+        size_t b = 0;               // second operand
+        const double *value = nullptr;
+        double constant = 0.0;
+        double sign = 1.0;          // predicate: v - c or c - v, eventually: 1 (max) or -1 (always, min of -v)
+        double lower = 0.0;         // interval [lower, upper]
+        double upper = 0.0;
+        bool used = false;
+
+        std::deque<Sample> out{};   // robustness not yet consumed by the parent
+        std::deque<Sample> window{};// monotonic queue (eventually, always)
+        std::deque<double> pending{};// times waiting for a complete window
+        std::deque<Pair> buffer{};  // paired inputs not yet in the interval (until)
+        std::vector<Entry> front{}; // interval of until as two stacks: front (oldest on top) and back
+        std::vector<Entry> back{};
+        Span backSpan = identity();
+
+
+    };
+
+    std::vector<Node> _nodes{};
+    std::vector<size_t> _order{}; // nodes of the monitored formula, operands first
+    size_t _root = 0;
+    bool _set = false;
+
+    Semantics _semantics = Semantics::GLOBALLY;
+    IStopCondition::StopCode _mode = IStopCondition::StopCode::OBJECTIVES_MISSED;
+
+    bool _evaluated = false;
+    double _robustness = std::numeric_limits<double>::quiet_NaN();
+
+
+public:
+
+
+    StlMonitor() = default;
+
+
+    /**
+     * Creates the predicate value > constant (robustness: value - constant)
+     * @param value Value
+     * @param constant Constant
+     * @return Formula
+     */
+    Formula greater(const double *value, double constant) {
+
+        Node n{Type::PREDICATE};
+        n.value = value;
+        n.constant = constant;
+        n.sign = 1.0;
+
+        return add(std::move(n));
+
+    }
+
+
+    /**
+     * Creates the predicate value < constant (robustness: constant - value)
+     * @param value Value
+     * @param constant Constant
+     * @return Formula
+     */
+    Formula less(const double *value, double constant) {
+
+        Node n{Type::PREDICATE};
+        n.value = value;
+        n.constant = constant;
+        n.sign = -1.0;
+
+        return add(std::move(n));
+
+    }
+
+
+    /**
+     * Creates the negation of a formula
+     * @param phi Formula
+     * @return Formula
+     */
+    Formula negate(Formula phi) {
+
+        Node n{Type::NOT};
+        n.a = use(phi);
+
+        return add(std::move(n));
+
+    }
+
+
+    /**
+     * Creates the conjunction of two formulas
+     * @param phi First formula
+     * @param psi Second formula
+     * @return Formula
+     */
+    Formula conjunction(Formula phi, Formula psi) {
+
+        Node n{Type::AND};
+        n.a = use(phi);
+        n.b = use(psi);
+
+        return add(std::move(n));
+
+    }
+
+
+    /**
+     * Creates the disjunction of two formulas
+     * @param phi First formula
+     * @param psi Second formula
+     * @return Formula
+     */
+    Formula disjunction(Formula phi, Formula psi) {
+
+        Node n{Type::OR};
+        n.a = use(phi);
+        n.b = use(psi);
+
+        return add(std::move(n));
+
+    }
+
+
+    /**
+     * Creates G[lower, upper] phi: phi holds at all times in the interval
+     * @param lower Start of the interval (relative time)
+     * @param upper End of the interval (relative time)
+     * @param phi Formula
+     * @return Formula
+     */
+    Formula always(double lower, double upper, Formula phi) {
+
+        return window(lower, upper, phi, -1.0);
+
+    }
+
+
+    /**
+     * Creates F[lower, upper] phi: phi holds at some time in the interval
+     * @param lower Start of the interval (relative time)
+     * @param upper End of the interval (relative time)
+     * @param phi Formula
+     * @return Formula
+     */
+    Formula eventually(double lower, double upper, Formula phi) {
+
+        return window(lower, upper, phi, 1.0);
+
+    }
+
+
+    /**
+     * Creates phi U[lower, upper] psi: psi holds at some time in the interval and phi holds until then
+     * @param lower Start of the interval (relative time)
+     * @param upper End of the interval (relative time)
+     * @param phi Formula to hold until psi
+     * @param psi Formula to be reached
+     * @return Formula
+     */
+    Formula until(double lower, double upper, Formula phi, Formula psi) {
+
+        checkInterval(lower, upper);
+
+        Node n{Type::UNTIL};
+        n.a = use(phi);
+        n.b = use(psi);
+        n.lower = lower;
+        n.upper = upper;
+
+        return add(std::move(n));
+
+    }
+
+
+    /**
+     * Sets the formula to be monitored
+     * @param formula Formula
+     * @param semantics Semantics (INITIAL: formula holds at the first step, GLOBALLY: formula holds at every step)
+     * @param mode Stop code to be set on violation
+     */
+    void setFormula(Formula formula, Semantics semantics = Semantics::GLOBALLY, Mode mode = Mode::OBJECTIVES_MISSED) {
+
+        if(formula >= _nodes.size())
+            throw std::invalid_argument("unknown formula");
+
+        _root = formula;
+        _semantics = semantics;
+
+        // collect the nodes of the formula (operands are always created before their parents)
+        _order.clear();
+        std::vector<size_t> stack{formula};
+        while(!stack.empty()) {
+
+            auto i = stack.back();
+            stack.pop_back();
+            _order.push_back(i);
+
+            auto &n = _nodes[i];
+            if(n.type != Type::PREDICATE)
+                stack.push_back(n.a);
+
+            if(n.type == Type::AND || n.type == Type::OR || n.type == Type::UNTIL)
+                stack.push_back(n.b);
+
+        }
+
+        std::sort(_order.begin(), _order.end());
+
+        _mode = mode;
+        _set = true;
+
+    }
+
+
+    /**
+     * Returns the last evaluated robustness of the formula (NaN, if no value has been evaluated yet)
+     * @return Robustness
+     */
+    double robustness() const {
+
+        return _robustness;
+
+    }
+
+
+    /**
+     * Returns if a verdict has been evaluated (INITIAL: the robustness at the first step is known)
+     * @return Flag
+     */
+    bool evaluated() const {
+
+        return _evaluated;
+
+    }
+
+
+    void initialize(double initTime) override {
+
+        if(!_set)
+            throw ModelNotInitialized("Formula is not set.");
+
+        reset();
+
+        _evaluated = false;
+        _robustness = std::numeric_limits<double>::quiet_NaN();
+
+        for(auto &n : _nodes) {
+            n.out.clear();
+            n.window.clear();
+            n.pending.clear();
+            n.buffer.clear();
+            n.front.clear();
+            n.back.clear();
+            n.backSpan = identity();
+        }
+
+    }
+
+
+    bool step(double simTime) override {
+
+        // propagate samples
+        for(auto i : _order)
+            update(_nodes[i], simTime);
+
+        // check robustness
+        auto &out = _nodes[_root].out;
+        while(!out.empty()) {
+
+            auto s = out.front();
+            out.pop_front();
+
+            if(_semantics == Semantics::INITIAL && _evaluated)
+                continue;
+
+            _robustness = s.v;
+            _evaluated = true;
+
+            if(s.v < 0.0 && !hasStopped()) {
+                setEvent(s.t, s.v);
+                stop(_mode);
+            }
+
+        }
+
+        return true;
+
+    }
+
+
+    void terminate(double simTime) override {
+
+    }
+
+
+private:
+
+
+    static void checkInterval(double lower, double upper) {
+
+        if(lower < 0.0 || upper < lower)
+            throw std::invalid_argument("interval must be 0 <= lower <= upper");
+
+    }
+
+
+    Formula add(Node &&node) {
+
+        _nodes.push_back(std::move(node));
+        return _nodes.size() - 1;
+
+    }
+
+
+    size_t use(Formula f) {
+
+        if(f >= _nodes.size())
+            throw std::invalid_argument("unknown formula");
+
+        if(_nodes[f].used)
+            throw std::invalid_argument("formula is already used as operand");
+
+        _nodes[f].used = true;
+        return f;
+
+    }
+
+
+    Formula window(double lower, double upper, Formula phi, double sign) {
+
+        checkInterval(lower, upper);
+
+        Node n{Type::EVENTUALLY};
+        n.a = use(phi);
+        n.lower = lower;
+        n.upper = upper;
+        n.sign = sign;
+
+        return add(std::move(n));
+
+    }
+
+
+    void update(Node &n, double simTime) {
+
+        switch(n.type) {
+
+            case Type::PREDICATE:
+                n.out.push_back({simTime, n.sign * (*n.value - n.constant)});
+                break;
+
+            case Type::NOT: {
+
+                auto &in = _nodes[n.a].out;
+                for(; !in.empty(); in.pop_front())
+                    n.out.push_back({in.front().t, -in.front().v});
+
+                break;
+
+            }
+
+            case Type::AND:
+            case Type::OR: {
+
+                auto &in1 = _nodes[n.a].out;
+                auto &in2 = _nodes[n.b].out;
+
+                // both operands are sampled at the same times
+                for(; !in1.empty() && !in2.empty(); in1.pop_front(), in2.pop_front()) {
+                    auto v1 = in1.front().v;
+                    auto v2 = in2.front().v;
+                    n.out.push_back({in1.front().t, n.type == Type::AND ? std::min(v1, v2) : std::max(v1, v2)});
+                }
+
+                break;
+
+            }
+
+            case Type::EVENTUALLY: {
+
+                auto &in = _nodes[n.a].out;
+                for(; !in.empty(); in.pop_front())
+                    slide(n, in.front().t, n.sign * in.front().v);
+
+                break;
+
+            }
+
+            case Type::UNTIL: {
+
+                auto &in1 = _nodes[n.a].out;
+                auto &in2 = _nodes[n.b].out;
+
+                for(; !in1.empty() && !in2.empty(); in1.pop_front(), in2.pop_front())
+                    sweep(n, {in1.front().t, in1.front().v, in2.front().v});
+
+                break;
+
+            }
+
+        }
+
+    }
+
+
+    /**
+     * Adds a sample to the sliding window maximum and emits the maximum of all complete windows
+     */
+    void slide(Node &n, double t, double v) {
+
+        // windows which end before the new sample
+        while(!n.pending.empty() && n.pending.front() + n.upper < t - EPS_SIM_TIME)
+            emitWindow(n);
+
+        // add sample to monotonic queue (decreasing values)
+        while(!n.window.empty() && n.window.back().v <= v)
+            n.window.pop_back();
+
+        n.window.push_back({t, v});
+        n.pending.push_back(t);
+
+        // windows which end with the new sample
+        while(!n.pending.empty() && n.pending.front() + n.upper <= t + EPS_SIM_TIME)
+            emitWindow(n);
+
+    }
+
+
+    void emitWindow(Node &n) {
+
+        auto t = n.pending.front();
+        n.pending.pop_front();
+
+        // remove samples before the window
+        while(!n.window.empty() && n.window.front().t < t + n.lower - EPS_SIM_TIME)
+            n.window.pop_front();
+
+        auto v = n.window.empty() ? -std::numeric_limits<double>::infinity() : n.window.front().v;
+        n.out.push_back({t, n.sign * v});
+
+    }
+
+
+    /**
+     * Adds a pair of samples to the until buffer and emits the robustness of all complete windows
+     */
+    void sweep(Node &n, const Pair &p) {
+
+        // windows which end before the new sample
+        while(!n.pending.empty() && n.pending.front() + n.upper < p.t - EPS_SIM_TIME)
+            emitUntil(n);
+
+        n.buffer.push_back(p);
+        n.pending.push_back(p.t);
+
+        // windows which end with the new sample
+        while(!n.pending.empty() && n.pending.front() + n.upper <= p.t + EPS_SIM_TIME)
+            emitUntil(n);
+
+    }
+
+
+    void emitUntil(Node &n) {
+
+        auto t = n.pending.front();
+        n.pending.pop_front();
+
+        // samples up to the end of the interval enter the interval
+        while(!n.buffer.empty() && n.buffer.front().t <= t + n.upper + EPS_SIM_TIME) {
+            n.back.push_back({n.buffer.front(), {}});
+            n.backSpan = combine(n.backSpan, single(n.buffer.front()));
+            n.buffer.pop_front();
+        }
+
+        // samples before the interval leave it and enter the minimum queue of phi
+        while((!n.front.empty() || !n.back.empty()) && oldest(n).t < t + n.lower - EPS_SIM_TIME) {
+
+            auto p = popOldest(n);
+
+            while(!n.window.empty() && n.window.back().v >= p.phi)
+                n.window.pop_back();
+
+            n.window.push_back({p.t, p.phi});
+
+        }
+
+        // samples before t are not needed anymore
+        while(!n.window.empty() && n.window.front().t < t - EPS_SIM_TIME)
+            n.window.pop_front();
+
+        // phi must hold before the interval and until psi within the interval
+        auto phi = n.window.empty() ? std::numeric_limits<double>::infinity() : n.window.front().v;
+        auto span = combine(n.front.empty() ? identity() : n.front.back().span, n.backSpan);
+
+        n.out.push_back({t, std::min(phi, span.value)});
+
+    }
+
+
+    static Span identity() {
+
+        return {std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+
+    }
+
+
+    static Span single(const Pair &p) {
+
+        return {p.phi, std::min(p.psi, p.phi)};
+
+    }
+
+
+    /**
+     * Combines the span of earlier samples with the span of the following samples (associative)
+     */
+    static Span combine(const Span &earlier, const Span &later) {
+
+        return {std::min(earlier.phi, later.phi), std::max(earlier.value, std::min(earlier.phi, later.value))};
+
+    }
+
+
+    static const Pair &oldest(const Node &n) {
+
+        return n.front.empty() ? n.back.front().p : n.front.back().p;
+
+    }
+
+
+    Pair popOldest(Node &n) {
+
+        // move the back stack to the front stack, newest first
+        if(n.front.empty()) {
+
+            auto span = identity();
+            for(auto it = n.back.rbegin(); it != n.back.rend(); ++it) {
+                span = combine(single(it->p), span);
+                n.front.push_back({it->p, span});
+            }
+
+            n.back.clear();
+            n.backSpan = identity();
+
+        }
+
+        auto p = n.front.back().p;
+        n.front.pop_back();
+
+        return p;
+
+    }
+
+};
+
+
+#endif //SIMCORE_STLMONITOR_H
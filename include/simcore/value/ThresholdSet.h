@@ -0,0 +1,247 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_THRESHOLDSET_H
+#define SIMCORE_THRESHOLDSET_H
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include "../IStopCondition.h"
+#include "../IComponent.h"
+
+/**
+ * A stop condition monitoring a set of values against lower and upper limits. The values are gathered into a
+ * contiguous array and all limits are checked in a single (vectorizable) pass per step. The simulation is stopped,
+ * when a value falls below its lower limit or exceeds its upper limit. The first trip (limit, index, time and value)
+ * is recorded. The time of the trip is interpolated between the previous and the current sample, where the value
+ * crossed the limit
+ */
+class ThresholdSet : public ::sim::IStopCondition, public ::sim::IComponent {
+
+public:
+
+    typedef IStopCondition::StopCode Mode;
+
+    enum class Limit { NONE, LOWER, UPPER };
+
+    struct Trip {
+        Limit limit = Limit::NONE; //!< tripped limit
+        size_t index = 0;          //!< index of the value
+        double time = 0.0;         //!< time of the trip (interpolated crossing)
+        double value = 0.0;        //!< value at the trip (the limit, if interpolated)
+    };
+
+
+private:
+
+    std::vector<const double *> _pointers{};
+    std::vector<double> _values{};
+    std::vector<double> _previous{};
+    double _previousTime = 0.0;
+    bool _hasPrevious = false;
+    std::vector<double> _lower{};
+    std::vector<double> _upper{};
+    std::vector<Mode> _modes{};
+    std::vector<unsigned char> _states{}; // per value: 0 in limits, 1 below lower, 2 above upper
+
+    Trip _trip{};
+
+
+public:
+
+
+    ThresholdSet() = default;
+
+
+    /**
+     * Adds a value to be monitored. The simulation is stopped when the value is lower than the lower limit or
+     * greater than the upper limit
+     * @param value Value to be monitored
+     * @param lower Lower limit (-infinity: no lower limit)
+     * @param upper Upper limit (infinity: no upper limit), must not be less than the lower limit
+     * @param mode Stop code to be set
+     * @return Index of the value
+     */
+    size_t add(const double *value, double lower, double upper, Mode mode = Mode::SIM_ENDED) {
+
+        if(!(lower <= upper))
+            throw std::invalid_argument("limits must be lower <= upper");
+
+        _pointers.push_back(value);
+        _lower.push_back(lower);
+        _upper.push_back(upper);
+        _modes.push_back(mode);
+
+        _values.resize(_pointers.size());
+        _previous.resize(_pointers.size());
+        _states.resize(_pointers.size());
+
+        return _pointers.size() - 1;
+
+    }
+
+
+    /**
+     * Adds a value to be monitored against an upper limit (like ValueExceed)
+     * @param value Value to be monitored
+     * @param limit Upper limit
+     * @param mode Stop code to be set
+     * @return Index of the value
+     */
+    size_t addUpper(const double *value, double limit, Mode mode = Mode::SIM_ENDED) {
+
+        return add(value, -std::numeric_limits<double>::infinity(), limit, mode);
+
+    }
+
+
+    /**
+     * Adds a value to be monitored against a lower limit
+     * @param value Value to be monitored
+     * @param limit Lower limit
+     * @param mode Stop code to be set
+     * @return Index of the value
+     */
+    size_t addLower(const double *value, double limit, Mode mode = Mode::SIM_ENDED) {
+
+        return add(value, limit, std::numeric_limits<double>::infinity(), mode);
+
+    }
+
+
+    /**
+     * Returns the number of monitored values
+     * @return Number of values
+     */
+    size_t size() const {
+
+        return _pointers.size();
+
+    }
+
+
+    /**
+     * Returns the limit state of a value at the last step
+     * @param index Index of the value
+     * @return Violated limit
+     */
+    Limit state(size_t index) const {
+
+        return static_cast<Limit>(_states.at(index));
+
+    }
+
+
+    /**
+     * Returns the first trip since the last initialization (limit is NONE if nothing tripped)
+     * @return Trip
+     */
+    const Trip &trip() const {
+
+        return _trip;
+
+    }
+
+
+    void initialize(double initTime) override {
+
+        reset();
+
+        _trip = Trip{};
+        _hasPrevious = false;
+        std::fill(_states.begin(), _states.end(), 0);
+
+    }
+
+
+    bool step(double simTime) override {
+
+        auto n = _pointers.size();
+
+        // keep the previous values and gather values
+        _values.swap(_previous);
+        for(size_t i = 0; i < n; ++i)
+            _values[i] = *_pointers[i];
+
+        auto hasPrevious = _hasPrevious;
+        auto previousTime = _previousTime;
+
+        _hasPrevious = true;
+        _previousTime = simTime;
+
+        // check limits (no branches, vectorizable)
+        auto v = _values.data();
+        auto lo = _lower.data();
+        auto up = _upper.data();
+        auto st = _states.data();
+
+        unsigned char any = 0;
+        for(size_t i = 0; i < n; ++i) {
+
+            st[i] = static_cast<unsigned char>((v[i] < lo[i]) | ((v[i] > up[i]) << 1));
+            any |= st[i];
+
+        }
+
+        if(any == 0 || _trip.limit != Limit::NONE)
+            return true;
+
+        // record the first tripped value
+        for(size_t i = 0; i < n; ++i) {
+
+            if(st[i] == 0)
+                continue;
+
+            _trip = {static_cast<Limit>(st[i]), i, simTime, v[i]};
+
+            // interpolate the crossing
+            auto limit = _trip.limit == Limit::LOWER ? lo[i] : up[i];
+            auto p = _previous[i];
+            if(hasPrevious && ((_trip.limit == Limit::LOWER && p >= limit && v[i] < p)
+                               || (_trip.limit == Limit::UPPER && p <= limit && v[i] > p))) {
+                _trip.time = previousTime + (limit - p) / (v[i] - p) * (simTime - previousTime);
+                _trip.value = limit;
+            }
+
+            setEvent(_trip.time, _trip.value);
+            stop(_modes[i]);
+
+            break;
+
+        }
+
+        return true;
+
+    }
+
+
+    void terminate(double simTime) override {
+
+    }
+
+};
+
+
+#endif //SIMCORE_THRESHOLDSET_H
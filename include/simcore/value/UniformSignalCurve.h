@@ -0,0 +1,318 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#ifndef SIMCORE_UNIFORMSIGNALCURVE_H
+#define SIMCORE_UNIFORMSIGNALCURVE_H
+
+#include "SignalCurve.h"
+
+/**
+ * A signal curve sampled on a uniform x grid. Only the first x-value, the step size and the y-values are stored, the
+ * segment of a value is calculated directly. The interface equals the interface of SignalCurve
+ */
+class UniformSignalCurve {
+
+    double _x0 = 0.0;
+    double _dx = 1.0;
+    std::vector<double> _y;
+
+
+public:
+
+
+    typedef SignalCurve::Position Position;
+    typedef SignalCurve::Cursor Cursor;
+
+
+    UniformSignalCurve() = default;
+    ~UniformSignalCurve() = default;
+
+    /**
+     * Define the curve
+     * @param x0 First x-value
+     * @param dx Step size
+     * @param y y-values
+     */
+    void define(double x0, double dx, std::vector<double> &&y) {
+
+        if(!(dx > 0.0))
+            throw std::invalid_argument("step size must be positive");
+
+        _x0 = x0;
+        _dx = dx;
+        _y = std::move(y);
+
+    }
+
+
+    /**
+     * Define the curve. The x-values must be uniformly spaced (with a relative tolerance of 1e-6 of the step size)
+     * @param x x-values
+     * @param y y-values
+     */
+    void define(std::vector<double> &&x, std::vector<double> &&y) {
+
+        if(x.size() != y.size())
+            throw std::invalid_argument("sizes must be equal");
+
+        if(x.size() < 2) {
+            define(x.empty() ? 0.0 : x.front(), 1.0, std::move(y));
+            return;
+        }
+
+        auto dx = (x.back() - x.front()) / static_cast<double>(x.size() - 1);
+
+        for(size_t i = 0; i < x.size(); ++i) {
+            if(!(std::fabs(x[i] - x.front() - dx * static_cast<double>(i)) <= 1e-6 * dx))
+                throw std::invalid_argument("x-values must be uniformly spaced");
+        }
+
+        define(x.front(), dx, std::move(y));
+
+    }
+
+
+    /**
+     * Check if the value is within defined boundaries
+     * @param x Value to be checked
+     * @return Flag if the value is in bounds
+     */
+    bool isInBounds(double x) const {
+
+        return x >= _x0 && x <= xAt(_y.size() - 1);
+
+    }
+
+
+    /**
+     * Calculates the y-value at the given x point by linear interpolation
+     * @param x x-value
+     * @return y-value
+     */
+    double interpolate(double x) const {
+
+        // check if x is out of bounds
+        if(x < _x0 - EPS_DISTANCE || x > xAt(_y.size() - 1) + EPS_DISTANCE)
+            throw std::invalid_argument("x out of bounds");
+
+        auto w = where(x);
+        return w.v0 - w.ds0 * (w.v1 - w.v0) / (w.ds1 - w.ds0);
+
+    }
+
+
+    /**
+     * Calculates the y-value at the given x point by linear interpolation. The cursor is not needed for the lookup
+     * and kept for compatibility with SignalCurve
+     * @param x x-value
+     * @param cursor Lookup hint, updated to the segment of x
+     * @return y-value
+     */
+    double interpolate(double x, Cursor &cursor) const {
+
+        auto y = interpolate(x);
+        cursor.segment = segment(x);
+
+        return y;
+
+    }
+
+
+    /**
+     * Calculates the y-values at the given x points by linear interpolation. Points out of bounds are set to NaN
+     * and flagged in the bit mask (bit i % 64 of word i / 64)
+     * @param xs x-values
+     * @param ys y-values (output, n elements)
+     * @param n Number of points
+     * @param outOfBounds Bit mask of the points out of bounds (output, resized to fit n bits)
+     * @return Number of points out of bounds
+     */
+    size_t interpolate(const double *xs, double *ys, size_t n, std::vector<std::uint64_t> &outOfBounds) const {
+
+        outOfBounds.assign((n + 63) / 64, 0);
+
+        auto lo = _x0 - EPS_DISTANCE;
+        auto hi = xAt(_y.size() - 1) + EPS_DISTANCE;
+
+        // interpolate
+        for(size_t i = 0; i < n; ++i) {
+
+            auto k = segment(xs[i]);
+            auto ds0 = xAt(k) - xs[i];
+            auto ds1 = xAt(k + 1) - xs[i];
+            ys[i] = _y[k] - ds0 * (_y[k + 1] - _y[k]) / (ds1 - ds0);
+
+        }
+
+        // flag points out of bounds
+        size_t count = 0;
+        for(size_t i = 0; i < n; ++i) {
+
+            if(xs[i] >= lo && xs[i] <= hi)
+                continue;
+
+            ys[i] = std::numeric_limits<double>::quiet_NaN();
+            outOfBounds[i / 64] |= std::uint64_t(1) << (i % 64);
+            ++count;
+
+        }
+
+        return count;
+
+    }
+
+
+    /**
+     * Returns the previous value
+     * @param x x-value
+     * @return y-value
+     */
+    double previous(double x) const {
+
+        // check if x is out of bounds
+        if(x < _x0 - EPS_DISTANCE)
+            throw std::invalid_argument("x out of bounds");
+
+        auto w = where(x);
+
+        if(w.ds1 <= 0.0)
+            return w.v1;
+        else
+            return w.v0;
+
+    }
+
+
+    /**
+     * Returns the next value
+     * @param x x-value
+     * @return y-value
+     */
+    double next(double x) const {
+
+        // check if x is out of bounds
+        if(x > xAt(_y.size() - 1) + EPS_DISTANCE)
+            throw std::invalid_argument("x out of bounds");
+
+        auto w = where(x);
+
+        if(w.ds0 > 0.0)
+            return w.v0;
+        else
+            return w.v1;
+
+    }
+
+
+    /**
+     * Returns the previous and the next value at the given point. If the value is out of bounds, the closest
+     * values are taken. The distances are given relative to the given position
+     * @param x x-Position
+     * @return Structure of positions and values
+     */
+    Position where(double x) const {
+
+        auto i = segment(x);
+        return {xAt(i) - x, _y[i], xAt(i + 1) - x, _y[i + 1]};
+
+    }
+
+
+    /**
+     * Returns the previous and the next value at the given point like where(x)
+     * @param x x-Position
+     * @param cursor Lookup hint, updated to the segment of x
+     * @return Structure of positions and values
+     */
+    Position where(double x, Cursor &cursor) const {
+
+        cursor.segment = segment(x);
+        return where(x);
+
+    }
+
+
+    /**
+     * Calculates if the data point hit the signal curve
+     * @param x x-value
+     * @param y y-value
+     * @param eps Tolerance (in y-direction, half band width)
+     * @return Flag
+     */
+    bool hit(double x, double y, double eps = EPS_DISTANCE) const {
+
+        return fabs(interpolate(x) - y) < eps;
+
+    }
+
+
+    /**
+     * Checks if the curve is set by at least two points
+     * @return true if more tha one point is set
+     */
+    bool isSet() const {
+
+        return _y.size() > 1;
+
+    }
+
+
+private:
+
+
+    double xAt(size_t i) const {
+
+        return _x0 + _dx * static_cast<double>(i);
+
+    }
+
+
+    /**
+     * Returns the index of the segment [x_i, x_i+1) containing x. Values out of bounds are assigned to the first or
+     * the last segment
+     * @param x x-value
+     * @return Index of the first point of the segment
+     */
+    size_t segment(double x) const {
+
+        auto last = _y.size() - 2;
+        auto f = std::floor((x - _x0) / _dx);
+
+        if(!(f > 0.0))
+            return 0;
+
+        auto i = f < static_cast<double>(last) ? static_cast<size_t>(f) : last;
+
+        // correct rounding at the grid points
+        if(i < last && xAt(i + 1) <= x)
+            ++i;
+        else if(i > 0 && x < xAt(i))
+            --i;
+
+        return i;
+
+    }
+
+};
+
+
+#endif //SIMCORE_UNIFORMSIGNALCURVE_H
@@ -25,9 +25,17 @@
 #ifndef SIMCORE_VALUEEXCEED_H
 #define SIMCORE_VALUEEXCEED_H
 
+#include <limits>
+#include <type_traits>
 #include "../IStopCondition.h"
 #include "../IComponent.h"
 
+/**
+ * Stops the simulation when the value exceeds the limit. For arithmetic types, the crossing is interpolated between
+ * the previous and the current sample and recorded as event. For other types, the time of the step is recorded and
+ * the value of the event is NaN
+ * @tparam T Type of the value (must be comparable by operator>)
+ */
 template<typename T>
 class ValueExceed : public ::sim::IStopCondition, public ::sim::IComponent {
 
@@ -36,6 +44,10 @@ class ValueExceed : public ::sim::IStopCondition, public ::sim::IComponent {
     const T* _value = nullptr;
     T _limit{};
 
+    bool _hasPrevious = false;
+    double _previousTime = 0.0;
+    double _previousValue = 0.0;
+
 public:
 
     typedef IStopCondition::StopCode Mode;
@@ -52,6 +64,7 @@ public:
     void initialize(double initTime) override {
 
         reset();
+        _hasPrevious = false;
 
     }
 
@@ -59,8 +72,17 @@ public:
     bool step(double simTime) override {
 
         // the limit has been reached
-        if(*_value > _limit)
+        if(*_value > _limit && !hasStopped()) {
+            localize(simTime);
             stop(_mode);
+        }
+
+        // store sample
+        _hasPrevious = true;
+        _previousTime = simTime;
+
+        if constexpr (std::is_arithmetic<T>::value)
+            _previousValue = static_cast<double>(*_value);
 
         return true;
 
@@ -71,6 +93,33 @@ public:
 
     }
 
+
+private:
+
+
+    void localize(double simTime) {
+
+        if constexpr (std::is_arithmetic<T>::value) {
+
+            auto value = static_cast<double>(*_value);
+            auto limit = static_cast<double>(_limit);
+
+            // interpolate the crossing between the previous and the current sample
+            if(_hasPrevious && _previousValue <= limit && value > _previousValue) {
+                auto f = (limit - _previousValue) / (value - _previousValue);
+                setEvent(_previousTime + f * (simTime - _previousTime), limit);
+            } else {
+                setEvent(simTime, value);
+            }
+
+        } else {
+
+            setEvent(simTime, std::numeric_limits<double>::quiet_NaN());
+
+        }
+
+    }
+
 };
 
 
@@ -37,6 +37,8 @@ class ValueOutOfTube : public SignalTube, public sim::IStopCondition, public sim
     const double *_x = nullptr;
     const double *_y = nullptr;
 
+    SignalTube::Cursor _cursor{};
+
 public:
 
     typedef IStopCondition::StopCode Mode;
@@ -48,12 +50,16 @@ public:
         if(!isSet())
             throw ModelNotInitialized("Band is not initialized.");
 
+        _cursor = SignalTube::Cursor{};
+
     }
 
     bool step(double simTime) override {
 
-        if(!in(*_x, *_y))
+        if(!in(*_x, *_y, _cursor) && !hasStopped()) {
+            setEvent(simTime, *_y);
             failed();
+        }
 
         return true;
 
@@ -36,8 +36,8 @@ void BasicSimulation::destroy() {
     stopTimer.reset();
     timeReporter.reset();
 
-    // clear stop conditions
-    stopConditions.clear();
+    // reset stop conditions
+    stopConditions.reset();
 
 }
 
@@ -56,17 +56,17 @@ void BasicSimulation::create(double endTime, double stepSize, bool realTime,
     stopTimer = std::make_unique<TimeIsUp>();
     stopTimer->setStopTime(endTime);
 
-    // stop condition (distance) TODO: test
-    for(auto e : stopValues) {
+    // stop condition (distance), all values are checked by one threshold set
+    if(!stopValues.empty()) {
 
         // create stop condition
-        auto b = std::make_unique<ValueExceed<double>>();
-        b->setValueAndLimit(e.first, e.second);
+        stopConditions = std::make_unique<ThresholdSet>();
+        for(auto e : stopValues)
+            stopConditions->addUpper(e.first, e.second);
 
         // add stop condition
-        addComponent(b.get());
-        addStopCondition(b.get());
-        stopConditions.push_back(std::move(b));
+        addComponent(stopConditions.get());
+        addStopCondition(stopConditions.get());
 
     }
 
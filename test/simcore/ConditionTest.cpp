@@ -0,0 +1,384 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+
+#include <simcore/Loop.h>
+#include <simcore/IComponent.h>
+#include <simcore/IStopCondition.h>
+#include <simcore/timers/BasicTimer.h>
+#include <simcore/timers/TimeIsUp.h>
+#include <simcore/data/Registry.h>
+#include <simcore/value/ExpressionCondition.h>
+#include <simcore/value/StlMonitor.h>
+#include <gtest/gtest.h>
+
+
+class ConditionTest : public ::testing::Test, public sim::IComponent {
+
+protected:
+
+    // create objects
+    BasicTimer timer;
+    TimeIsUp stop;
+    ::sim::Loop sim;
+    sim::data::Registry registry;
+
+    double speed = 0.0;
+    float distance = 100.0f;
+    int lane = 1;
+    bool braking = false;
+    double gap = 100.0;
+
+    void SetUp() override {
+
+        // set parameters
+        timer.setTimeStepSize(0.1);
+        stop.setStopTime(10.0);
+
+        // set timer and stop condition
+        sim.setTimer(&timer);
+        sim.addStopCondition(&stop);
+
+        // models
+        sim.addComponent(&stop);
+        sim.addComponent(this);
+
+        // publish values
+        registry.publish("ego.speed", &speed);
+        registry.publish("distance", &distance);
+        registry.publish("ego lane", &lane);
+        registry.publish("braking", &braking);
+
+    }
+
+
+public:
+
+    void initialize(double initTime) override {
+
+        speed = 0.0;
+        distance = 100.0f;
+
+    }
+
+    bool step(double simTime) override {
+
+        // accelerate and approach
+        speed = 5.0 * simTime;
+        distance = static_cast<float>(100.0 - 10.0 * simTime);
+        braking = simTime >= 7.0;
+        gap = distance;
+
+        return true;
+
+    }
+
+    void terminate(double simTime) override {
+    }
+
+};
+
+
+TEST_F(ConditionTest, ExpressionEvaluate) {
+
+    ExpressionCondition cond;
+
+    speed = 31.0;
+    distance = 4.5f;
+
+    auto eval = [&cond, this] (const std::string &expr) {
+        cond.setExpression(expr, registry);
+        return cond.evaluate();
+    };
+
+    // arithmetic and precedence
+    EXPECT_DOUBLE_EQ(7.0, eval("1 + 2 * 3"));
+    EXPECT_DOUBLE_EQ(9.0, eval("(1 + 2) * 3"));
+    EXPECT_DOUBLE_EQ(-1.0, eval("1 - 2"));
+    EXPECT_DOUBLE_EQ(2.0, eval("-1 - -3"));
+    EXPECT_DOUBLE_EQ(0.5, eval("1 / 2"));
+    EXPECT_DOUBLE_EQ(8.0, eval("2 - 3 + 9"));
+    EXPECT_DOUBLE_EQ(1500.0, eval("1.5e3"));
+
+    // typed loads
+    EXPECT_DOUBLE_EQ(31.0, eval("ego.speed"));
+    EXPECT_DOUBLE_EQ(4.5, eval("distance"));
+    EXPECT_DOUBLE_EQ(2.0, eval("\"ego lane\" * 2"));
+    EXPECT_DOUBLE_EQ(0.0, eval("braking"));
+
+    // comparisons and logic
+    EXPECT_DOUBLE_EQ(1.0, eval("ego.speed > 30 and distance < 5"));
+    EXPECT_DOUBLE_EQ(0.0, eval("ego.speed > 30 && distance < 4"));
+    EXPECT_DOUBLE_EQ(1.0, eval("ego.speed > 40 || distance <= 4.5"));
+    EXPECT_DOUBLE_EQ(1.0, eval("not braking"));
+    EXPECT_DOUBLE_EQ(0.0, eval("!(1 == 1)"));
+    EXPECT_DOUBLE_EQ(1.0, eval("1 != 2 and true"));
+    EXPECT_DOUBLE_EQ(1.0, eval("false or 2 >= 2"));
+
+    // hold time
+    cond.setExpression("ego.speed > 30 for 0.5 s", registry);
+    EXPECT_DOUBLE_EQ(0.5, cond.holdTime());
+
+    cond.setExpression("ego.speed > 30 for 2", registry);
+    EXPECT_DOUBLE_EQ(2.0, cond.holdTime());
+
+    // errors
+    EXPECT_THROW(cond.setExpression("unknown > 1", registry), std::invalid_argument);
+    EXPECT_THROW(cond.setExpression("1 +", registry), std::invalid_argument);
+    EXPECT_THROW(cond.setExpression("(1 + 2", registry), std::invalid_argument);
+    EXPECT_THROW(cond.setExpression("1 < 2 < 3", registry), std::invalid_argument);
+    EXPECT_THROW(cond.setExpression("1 # 2", registry), std::invalid_argument);
+    EXPECT_THROW(cond.setExpression("1 for", registry), std::invalid_argument);
+
+}
+
+
+TEST_F(ConditionTest, ExpressionRejected) {
+
+    ExpressionCondition cond;
+    speed = 31.0;
+
+    // no expression set
+    EXPECT_THROW(cond.evaluate(), std::runtime_error);
+    EXPECT_THROW(cond.setExpression("1 +", registry), std::invalid_argument);
+    EXPECT_THROW(cond.evaluate(), std::runtime_error);
+
+    cond.setExpression("ego.speed * 2 for 0.5", registry);
+
+    // a rejected expression keeps the previous one
+    EXPECT_THROW(cond.setExpression("1 + 2 * (3 +", registry), std::invalid_argument);
+    EXPECT_THROW(cond.setExpression("1 + 2 * unknown for 2", registry), std::invalid_argument);
+    EXPECT_THROW(cond.setExpression("(1 + 2) * 3 for 2 3", registry), std::invalid_argument);
+
+    EXPECT_EQ("ego.speed * 2 for 0.5", cond.expression());
+    EXPECT_DOUBLE_EQ(0.5, cond.holdTime());
+    EXPECT_DOUBLE_EQ(62.0, cond.evaluate());
+
+    // a larger expression can be set afterwards
+    cond.setExpression("(1 + 2) * (3 + 4) - ego.speed", registry);
+    EXPECT_DOUBLE_EQ(-10.0, cond.evaluate());
+
+}
+
+
+TEST_F(ConditionTest, ExpressionStop) {
+
+    // stops immediately
+    ExpressionCondition cond;
+    cond.setExpression("ego.speed > 30 and distance < 50", registry, ExpressionCondition::Mode::OBJECTIVES_MISSED);
+
+    sim.addComponent(&cond);
+    sim.addStopCondition(&cond);
+    sim.run();
+
+    EXPECT_EQ(::sim::IStopCondition::StopCode::OBJECTIVES_MISSED, cond.getCode());
+    EXPECT_NEAR(6.1, timer.time(), 1e-9);
+
+    EXPECT_TRUE(cond.event().valid);
+    EXPECT_NEAR(6.1, cond.event().time, 1e-9);
+    EXPECT_DOUBLE_EQ(1.0, cond.event().value);
+
+    // with hold time
+    cond.setExpression("ego.speed > 30 and distance < 50 for 0.5 s", registry);
+    sim.run();
+
+    EXPECT_EQ(::sim::IStopCondition::StopCode::SIM_ENDED, cond.getCode());
+    EXPECT_NEAR(6.6, timer.time(), 1e-9);
+
+    // hold time is restarted when the expression is false
+    cond.setExpression("ego.speed > 30 and not braking for 1.0", registry);
+    sim.run();
+
+    EXPECT_EQ(::sim::IStopCondition::StopCode::NONE, cond.getCode());
+    EXPECT_NEAR(10.0, timer.time(), 1e-9);
+
+}
+
+
+TEST_F(ConditionTest, StlRobustness) {
+
+    // signal with known values: x(t) = 10 t (time step 0.1)
+    StlMonitor mon;
+    auto p = mon.greater(&speed, 20.0);
+    auto f = mon.eventually(0.0, 1.0, p);
+    mon.setFormula(f, StlMonitor::Semantics::GLOBALLY, StlMonitor::Mode::OBJECTIVES_MISSED);
+
+    mon.initialize(0.0);
+
+    // F[0,1] (x > 20): robustness at t is x(t + 1) - 20, known at t + 1
+    for(unsigned int i = 0; i <= 20; ++i) {
+
+        speed = 10.0 * i * 0.1;
+        mon.step(i * 0.1);
+
+        if(i < 10)
+            EXPECT_TRUE(std::isnan(mon.robustness()));
+        else
+            EXPECT_NEAR(10.0 * (i * 0.1) - 20.0, mon.robustness(), 1e-9);
+
+    }
+
+    // violated for t = 0
+    EXPECT_EQ(::sim::IStopCondition::StopCode::OBJECTIVES_MISSED, mon.getCode());
+    EXPECT_NEAR(0.0, mon.event().time, 1e-9);
+    EXPECT_NEAR(-10.0, mon.event().value, 1e-9);
+
+    // always, not, and, or
+    StlMonitor mon2;
+    auto a = mon2.always(0.0, 0.5, mon2.less(&speed, 3.0));
+    auto b = mon2.negate(mon2.greater(&speed, 1.0));
+    auto c = mon2.disjunction(a, mon2.conjunction(b, mon2.greater(&speed, -1.0)));
+    mon2.setFormula(c);
+
+    // speed: 0, 1, 2, ..., G[0,0.5] (x < 3) = 3 - x(t + 0.5)
+    mon2.initialize(0.0);
+    for(unsigned int i = 0; i <= 5; ++i) {
+        speed = i;
+        mon2.step(i * 0.1);
+    }
+
+    // at t = 0: max(3 - 5, min(-(0 - 1), 0 + 1)) = 1
+    EXPECT_NEAR(1.0, mon2.robustness(), 1e-9);
+    EXPECT_FALSE(mon2.hasStopped());
+
+    // operands can only be used once
+    EXPECT_THROW(mon2.negate(b), std::invalid_argument);
+    EXPECT_THROW(mon2.always(1.0, 0.5, mon2.greater(&speed, 0.0)), std::invalid_argument);
+
+}
+
+
+TEST_F(ConditionTest, StlUntil) {
+
+    // (x < 5) U[0, 2] (x > 3), x(t) = t
+    StlMonitor mon;
+    auto u = mon.until(0.0, 2.0, mon.less(&speed, 5.0), mon.greater(&speed, 3.0));
+    mon.setFormula(u);
+    mon.initialize(0.0);
+
+    std::vector<double> rob;
+    for(unsigned int i = 0; i <= 40; ++i) {
+
+        speed = i * 0.1;
+        mon.step(i * 0.1);
+
+        if(i >= 20)
+            rob.push_back(mon.robustness());
+
+    }
+
+    // brute force reference
+    for(unsigned int k = 0; k < rob.size(); ++k) {
+
+        double best = -INFINITY, phi = INFINITY;
+        for(unsigned int j = k; j <= k + 20; ++j) {
+            phi = std::min(phi, 5.0 - j * 0.1);
+            best = std::max(best, std::min(j * 0.1 - 3.0, phi));
+        }
+
+        EXPECT_NEAR(best, rob[k], 1e-9);
+
+    }
+
+    // t = 0: x reaches 3 within 2 s -> violated
+    EXPECT_TRUE(mon.hasStopped());
+    EXPECT_NEAR(0.0, mon.event().time, 1e-9);
+
+}
+
+
+TEST_F(ConditionTest, StlUntilInterval) {
+
+    // (a > 0) U[0.5, 1.5] (b > 0) with oscillating signals
+    auto a = [] (unsigned int i) { return std::sin(0.07 * i) + 0.3; };
+    auto b = [] (unsigned int i) { return std::cos(0.13 * i); };
+
+    StlMonitor mon;
+    auto u = mon.until(0.5, 1.5, mon.greater(&speed, 0.0), mon.greater(&gap, 0.0));
+    mon.setFormula(u);
+    mon.initialize(0.0);
+
+    std::vector<double> rob;
+    for(unsigned int i = 0; i <= 500; ++i) {
+
+        speed = a(i);
+        gap = b(i);
+        mon.step(i * 0.1);
+
+        if(i >= 15)
+            rob.push_back(mon.robustness());
+
+    }
+
+    // brute force reference
+    for(unsigned int k = 0; k < rob.size(); ++k) {
+
+        double best = -INFINITY, phi = INFINITY;
+        for(unsigned int j = k; j <= k + 15; ++j) {
+
+            phi = std::min(phi, a(j));
+
+            if(j >= k + 5)
+                best = std::max(best, std::min(b(j), phi));
+
+        }
+
+        EXPECT_NEAR(best, rob[k], 1e-9);
+
+    }
+
+}
+
+
+TEST_F(ConditionTest, StlStop) {
+
+    // speed = 5 t, distance = 100 - 10 t: always within 1 s: speed < 30 -> violated at t = 5
+    StlMonitor always;
+    always.setFormula(always.always(0.0, 1.0, always.less(&speed, 30.0)));
+
+    sim.addComponent(&always);
+    sim.addStopCondition(&always);
+    sim.run();
+
+    EXPECT_TRUE(always.hasStopped());
+    EXPECT_NEAR(5.0, always.event().time, 0.11);
+    EXPECT_NEAR(6.1, timer.time(), 0.11);
+
+    // initial: eventually within 10 s distance < 50 -> satisfied, not stopped
+    StlMonitor initial;
+    initial.setFormula(initial.eventually(0.0, 8.0, initial.less(&gap, 50.0)), StlMonitor::Semantics::INITIAL);
+
+    ::sim::Loop loop;
+    loop.setTimer(&timer);
+    loop.addStopCondition(&stop);
+    loop.addComponent(&stop);
+    loop.addComponent(this);
+    loop.addComponent(&initial);
+    loop.addStopCondition(&initial);
+    loop.run();
+
+    EXPECT_FALSE(initial.hasStopped());
+    EXPECT_TRUE(initial.evaluated());
+    EXPECT_GT(initial.robustness(), 0.0);
+    EXPECT_NEAR(10.0, timer.time(), 1e-9);
+
+}
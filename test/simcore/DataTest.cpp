@@ -30,7 +30,10 @@
 #include <simcore/timers/TimeIsUp.h>
 #include <simcore/data/TimeReporter.h>
 #include <simcore/data/DataManager.h>
+#include <simcore/data/JsonFormat.h>
+#include <simcore/data/DataManagerReporter.h>
 #include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
 #include <map>
 
 
@@ -238,3 +241,241 @@ TEST_F(DataTest, DataManager) {
 
 }
 
+
+
+TEST_F(DataTest, DataManagerHandles) {
+
+    using namespace ::sim;
+    using namespace ::sim::data;
+
+    // register model and a vector of models to data manager
+    DataManager data;
+    data.registerStorable("Test", *this);
+    data.registerStorableVector("Vector", {this, this});
+
+    // resolve handles before the simulation
+    auto sa = data.resolve("Test.state.sa");
+    auto pb = data.resolve("Vector.parameter.pb");
+    EXPECT_THROW(data.resolve("Test.state.sc"), std::invalid_argument);
+
+    EXPECT_TRUE(data.isValid(sa));
+    EXPECT_FALSE(data.isValid(DataManager::Handle{}));
+
+    // add this to loop
+    loop.addComponent(this);
+    loop.run();
+
+    // access via handles
+    EXPECT_NEAR(0.1, data.getValue<double>(sa), 1e-9);
+    EXPECT_NEAR(5.0, data.getValue<double>(pb), 1e-9);
+    EXPECT_EQ(data.getValue("Test.state.sa"), data.getValue(sa));
+
+    // check vector structure
+    std::stringstream ss;
+    data.streamTo(ss);
+
+    auto j = nlohmann::json::parse(ss.str());
+    ASSERT_TRUE(j["Vector"].is_array());
+    ASSERT_EQ(2, j["Vector"].size());
+    EXPECT_EQ(j["Test"], j["Vector"][0]);
+    EXPECT_EQ(j["Test"], j["Vector"][1]);
+
+}
+
+
+TEST_F(DataTest, DataManagerReporter) {
+
+    using namespace ::sim;
+    using namespace ::sim::data;
+
+    // register model to data manager
+    DataManager data;
+    data.registerStorable("Test", *this);
+
+    // create reporter
+    std::stringstream ss;
+    DataManagerReporter reporter;
+    reporter.setDataManager(data);
+    reporter.setOutstream(ss);
+    reporter.setTimeStepSize(1.0);
+
+    // add this and reporter to loop
+    loop.addComponent(this);
+    loop.addComponent(&reporter);
+    loop.run();
+
+    // parse output
+    auto j = nlohmann::json::parse(ss.str());
+    auto &rows = j["rows"];
+    ASSERT_EQ(11, rows.size());
+    ASSERT_EQ(data.size() + 1, rows[0].size());
+
+    // check structure and values
+    auto pa = j["structure"]["Test"]["parameter"]["pa"].get<std::size_t>();
+    auto ia = j["structure"]["Test"]["input"]["ia"].get<std::size_t>();
+    auto sa = j["structure"]["Test"]["state"]["sa"].get<std::size_t>();
+    auto name = j["structure"]["Test"]["parameter"]["name"].get<std::size_t>();
+
+    for(std::size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_NEAR(1.0 * i, rows[i][0].get<double>(), 1e-9);
+        EXPECT_NEAR(4.0, rows[i][pa].get<double>(), 1e-9);
+        EXPECT_NEAR(2.0, rows[i][ia].get<double>(), 1e-9);
+        EXPECT_EQ("DataTest", rows[i][name].get<std::string>());
+    }
+
+    EXPECT_NEAR(0.0, rows[0][sa].get<double>(), 1e-9);
+    EXPECT_NEAR(0.1, rows[10][sa].get<double>(), 1e-9);
+
+}
+
+
+class FieldStorable : public sim::data::IStorable {
+
+public:
+
+    struct Parameters {
+        double mass;
+        int axles;
+    };
+
+    struct State {
+        double velocity;
+        bool braking;
+    };
+
+    Parameters param{1500.0, 2};
+    State state{10.0, false};
+
+
+    sim::data::FieldTable getFields(Context context) const override {
+
+        using namespace ::sim::data;
+
+        static constexpr FieldDescriptor parameterFields[] = {
+                DATA_FIELD(Parameters, mass),
+                DATA_FIELD(Parameters, axles)
+        };
+
+        static constexpr FieldDescriptor stateFields[] = {
+                DATA_FIELD(State, velocity),
+                DATA_FIELD(State, braking)
+        };
+
+        switch(context) {
+            case Context::PARAMETER:
+                return createFieldTable(parameterFields, &param);
+            case Context::STATE:
+                return createFieldTable(stateFields, &state);
+            default:
+                return {};
+        }
+
+    }
+
+};
+
+
+TEST(DataTestBasic, FieldTable) {
+
+    using namespace ::sim::data;
+
+    FieldStorable store;
+
+    // check table
+    auto table = store.getFields(IStorable::PARAMETER);
+    ASSERT_EQ(2, table.size);
+    EXPECT_STREQ("axles", table.fields[1].name);
+    EXPECT_EQ(DataType::INT, table.fields[1].type);
+    EXPECT_EQ(&store.param.axles, table.pointer(1));
+
+    // data entries are created from the table
+    auto entries = store.getData(IStorable::STATE);
+    ASSERT_EQ(2, entries.size());
+    EXPECT_EQ("braking", entries[1].name);
+    EXPECT_EQ(&store.state.braking, entries[1].data->v());
+    EXPECT_TRUE(store.getData(IStorable::INPUT).empty());
+
+    // register to data manager
+    DataManager data;
+    data.registerStorable("Unit", store);
+
+    store.state.velocity = 12.5;
+    store.state.braking = true;
+
+    EXPECT_EQ(2, data.getValue<int>("Unit.parameter.axles"));
+    EXPECT_DOUBLE_EQ(12.5, data.getValue<double>("Unit.state.velocity"));
+
+    std::stringstream ss;
+    data.streamTo(ss);
+
+    EXPECT_EQ(R"({"Unit":{"input":{},"parameter":{"axles":2,"mass":1500},"state":{"braking":true,"velocity":12.5}}})",
+            ss.str());
+
+}
+
+
+TEST(DataTestBasic, DataManagerRowPrecision) {
+
+    using namespace ::sim::data;
+
+    FieldStorable store;
+    store.state.velocity = 12.3456789;
+
+    DataManager data;
+    data.registerStorable("Unit", store);
+
+    // the time is written exactly, also for long runs
+    std::stringstream ss;
+    data.streamValuesTo(ss, 1000.001);
+
+    auto row = nlohmann::json::parse(ss.str());
+    EXPECT_EQ(1000.001, row[0].get<double>());
+
+    // the values are written with six digits by default
+    auto velocity = data.resolve("Unit.state.velocity").leaf + 1;
+    EXPECT_EQ(12.3457, row[velocity].get<double>());
+
+    // the value precision can be set
+    data.setPrecision(0);
+
+    ss.str("");
+    data.streamValuesTo(ss, 1000.002);
+
+    row = nlohmann::json::parse(ss.str());
+    EXPECT_EQ(1000.002, row[0].get<double>());
+    EXPECT_EQ(12.3456789, row[velocity].get<double>());
+
+}
+
+
+TEST(DataTestBasic, JsonFormat) {
+
+    using namespace ::sim::data;
+
+    std::string out;
+
+    // numbers
+    appendJson(out, 0.1);
+    out.push_back(' ');
+    appendJson(out, 1.0 / 3.0, 4);
+    out.push_back(' ');
+    appendJson(out, -42);
+    out.push_back(' ');
+    appendJson(out, NAN);
+    out.push_back(' ');
+    appendJson(out, true);
+
+    EXPECT_EQ("0.1 0.3333 -42 null true", out);
+
+    // shortest representation is exact
+    out.clear();
+    appendJson(out, 0.1 + 0.2);
+    EXPECT_EQ(0.1 + 0.2, std::stod(out));
+
+    // escaped strings
+    out.clear();
+    appendJson(out, std::string("a\"b\\c\n\x01"));
+    EXPECT_EQ(R"("a\"b\\c\n\u0001")", out);
+    EXPECT_EQ("a\"b\\c\n\x01", nlohmann::json::parse(out).get<std::string>());
+
+}
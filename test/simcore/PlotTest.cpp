@@ -30,7 +30,12 @@
 #include <simcore/data/PlotLogger.h>
 #include <simcore/data/JsonFileReporter.h>
 #include <simcore/functions.h>
+#include <nlohmann/json.hpp>
 #include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
 #include <cmath>
 
 
@@ -122,3 +127,351 @@ TEST_F(PlotTest, SaveData) {
     loop.run();
 
 }
+
+
+TEST_F(PlotTest, Deadband) {
+
+    auto plotFile = sim::fnc::string_format("%s/plot_deadband.json", LOG_DIR);
+
+    // create plot definition with deadband on value 1
+    plotLogger.create(plotFile, "Deadband Test");
+    plotLogger.defineDataset({"time", "a"}, {&time, &value1});
+    plotLogger.setDeadband("a", 0.5);
+    plotLogger.addFigure("first", "Value 1 over time", "Time t [s]", "Value v [-]", "time", "a");
+
+    // run loop
+    jsonLogger.setFilename(sim::fnc::string_format("%s/data_deadband.json", LOG_DIR));
+    loop.run();
+
+    // read dataset
+    std::ifstream f(plotFile);
+    auto rows = nlohmann::json::parse(f)["dataset"];
+
+    // rows are reduced, the last step is written
+    ASSERT_GT(rows.size(), 2);
+    EXPECT_LT(rows.size(), 100);
+    EXPECT_NEAR(10.0, rows.back()["time"].get<double>(), 1e-6);
+
+    // the values can be reconstructed within the deadband
+    for(size_t i = 0; i + 1 < rows.size(); ++i) {
+
+        auto t0 = rows[i]["time"].get<double>();
+        auto t1 = rows[i + 1]["time"].get<double>();
+        auto v = rows[i]["a"].get<double>();
+
+        for(double t = t0; t < t1 - 1e-6; t += 0.01)
+            EXPECT_LE(fabs(cos(t * 2.0) - v), 0.5 + 1e-6);
+
+    }
+
+}
+
+
+TEST_F(PlotTest, Downsampling) {
+
+    for(auto mode : {sim::data::Downsampling::MINMAX, sim::data::Downsampling::LTTB}) {
+
+        auto plotFile = sim::fnc::string_format("%s/plot_downsampled_%d.json", LOG_DIR, static_cast<int>(mode));
+
+        // create plot definition with downsampling
+        PlotLogger logger;
+        logger.create(plotFile, "Downsampling Test");
+        logger.defineDataset({"time", "a", "b"}, {&time, &value1, &value2});
+        logger.setDownsampling(mode, 50);
+        logger.addFigure("first", "Value 1 and 2 over time", "Time t [s]", "Value v [-]", "time", {{"Value 1", "a"}, {"Value 2", "b"}});
+
+        // run loop with the logger
+        ::sim::Loop l;
+        l.setTimer(&timer);
+        l.addStopCondition(&stop);
+        l.addComponent(&stop);
+        l.addComponent(this);
+        l.addComponent(&logger);
+        l.run();
+
+        // read plot
+        std::ifstream f(plotFile);
+        auto plot = nlohmann::json::parse(f);
+
+        EXPECT_TRUE(plot["dataset"].empty());
+
+        for(auto &tr : plot["plots"][0]["traces"]) {
+
+            auto x = tr["x"].get<std::vector<double>>();
+            auto y = tr["y"].get<std::vector<double>>();
+
+            ASSERT_EQ(x.size(), y.size());
+            EXPECT_LE(x.size(), 50);
+            EXPECT_GT(x.size(), 20);
+
+            // first and last sample are kept
+            EXPECT_NEAR(0.0, x.front(), 1e-6);
+            EXPECT_NEAR(10.0, x.back(), 1e-6);
+            EXPECT_TRUE(std::is_sorted(x.begin(), x.end()));
+
+            // peaks are kept by min/max
+            if(mode == sim::data::Downsampling::MINMAX) {
+                EXPECT_NEAR(1.0, *std::max_element(y.begin(), y.end()), 1e-4);
+                EXPECT_NEAR(-1.0, *std::min_element(y.begin(), y.end()), 1e-4);
+            }
+
+        }
+
+    }
+
+}
+
+
+TEST_F(PlotTest, DownsamplingDistribution) {
+
+    for(auto mode : {sim::data::Downsampling::MINMAX, sim::data::Downsampling::LTTB}) {
+
+        // long trace with a single early peak
+        sim::data::Downsampler sampler(mode, 100);
+        for(size_t i = 0; i < 100000; ++i)
+            sampler.add(static_cast<double>(i), i == 1000 ? 10.0 : sin(static_cast<double>(i) * 0.01));
+
+        std::vector<double> x, y;
+        sampler.result(x, y);
+
+        ASSERT_LE(x.size(), 100);
+        EXPECT_TRUE(std::is_sorted(x.begin(), x.end()));
+
+        // the points are spread evenly over the run
+        size_t quarters[4] = {0, 0, 0, 0};
+        for(auto v : x)
+            quarters[std::min(static_cast<size_t>(v / 25000.0), static_cast<size_t>(3))]++;
+
+        for(auto n : quarters)
+            EXPECT_GE(n, 20);
+
+        // the early peak survives
+        auto it = std::max_element(y.begin(), y.end());
+        EXPECT_DOUBLE_EQ(10.0, *it);
+        EXPECT_DOUBLE_EQ(1000.0, x[std::distance(y.begin(), it)]);
+
+    }
+
+}
+
+
+std::vector<unsigned char> decodeBase64(const std::string &str) {
+
+    static const std::string table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::vector<unsigned char> bytes;
+    unsigned int v = 0, n = 0;
+    for(char c : str) {
+
+        if(c == '=')
+            break;
+
+        v = (v << 6u) | static_cast<unsigned int>(table.find(c));
+        if(++n == 4) {
+            bytes.push_back((v >> 16u) & 0xffu);
+            bytes.push_back((v >> 8u) & 0xffu);
+            bytes.push_back(v & 0xffu);
+            v = n = 0;
+        }
+
+    }
+
+    if(n == 2)
+        bytes.push_back((v >> 4u) & 0xffu);
+    else if(n == 3) {
+        bytes.push_back((v >> 10u) & 0xffu);
+        bytes.push_back((v >> 2u) & 0xffu);
+    }
+
+    return bytes;
+
+}
+
+
+TEST_F(PlotTest, TypedArrays) {
+
+    auto plotFile = sim::fnc::string_format("%s/plot_typed.json", LOG_DIR);
+
+    // create plot definition with static trace and dataset
+    plotLogger.create(plotFile, "Typed Array Test");
+    plotLogger.defineDataset({"time", "a"}, {&time, &value1});
+    plotLogger.setEncoding(sim::data::ArrayEncoding::FLOAT64);
+    plotLogger.addFigure("first", "Value 1 over time", "Time t [s]", "Value v [-]", "time", "a");
+    plotLogger.trace("first", "static", std::vector<double>{0.0, 1.0, 2.0}, std::vector<double>{0.5, -0.25, 1e10}, "auto", 1);
+
+    // run loop
+    jsonLogger.setFilename(sim::fnc::string_format("%s/data_typed.json", LOG_DIR));
+    loop.run();
+
+    std::ifstream f(plotFile);
+    auto plot = nlohmann::json::parse(f);
+
+    // static trace
+    auto tr = plot["plots"][0]["traces"][1];
+    EXPECT_EQ("float64", tr["y"]["dtype"]);
+
+    auto bytes = decodeBase64(tr["y"]["data"].get<std::string>());
+    ASSERT_EQ(24, bytes.size());
+
+    double y[3];
+    std::memcpy(y, bytes.data(), 24);
+    EXPECT_DOUBLE_EQ(0.5, y[0]);
+    EXPECT_DOUBLE_EQ(-0.25, y[1]);
+    EXPECT_DOUBLE_EQ(1e10, y[2]);
+
+    // dataset columns are written in chunks
+    auto chunks = plot["dataset"]["chunks"];
+    ASSERT_EQ(1, chunks.size());
+
+    bytes = decodeBase64(chunks[0]["a"]["data"].get<std::string>());
+    ASSERT_EQ(1001 * 8, bytes.size());
+
+    std::vector<double> a(1001);
+    std::memcpy(a.data(), bytes.data(), bytes.size());
+    EXPECT_DOUBLE_EQ(1.0, a[0]);
+    EXPECT_NEAR(cos(20.0), a[1000], 1e-9);
+
+}
+
+
+TEST_F(PlotTest, TypedArraysSidecar) {
+
+    auto plotFile = sim::fnc::string_format("%s/plot_sidecar.json", LOG_DIR);
+    auto binFile = sim::fnc::string_format("%s/plot_sidecar.bin", LOG_DIR);
+
+    // create plot definition with sidecar file
+    plotLogger.create(plotFile, "Sidecar Test");
+    plotLogger.defineDataset({"time", "a"}, {&time, &value1});
+    plotLogger.setEncoding(sim::data::ArrayEncoding::FLOAT32, binFile);
+    plotLogger.addFigure("first", "Value 1 over time", "Time t [s]", "Value v [-]", "time", "a");
+
+    // run loop long enough to write more than one chunk
+    stop.setStopTime(50.0);
+    jsonLogger.setFilename(sim::fnc::string_format("%s/data_sidecar.json", LOG_DIR));
+    loop.run();
+
+    std::ifstream f(plotFile);
+    auto chunks = nlohmann::json::parse(f)["dataset"]["chunks"];
+
+    ASSERT_EQ(2, chunks.size());
+
+    // read column blocks from sidecar
+    std::ifstream bin(binFile, std::ios::binary);
+    std::vector<float> t;
+
+    for(auto &c : chunks) {
+
+        auto &b = c["time"];
+
+        EXPECT_EQ("float32", b["dtype"]);
+        EXPECT_EQ(binFile, b["file"]);
+
+        auto n = b["length"].get<size_t>();
+        bin.seekg(b["offset"].get<long>());
+
+        t.resize(t.size() + n);
+        bin.read(reinterpret_cast<char *>(t.data() + t.size() - n), static_cast<std::streamsize>(n * 4));
+
+    }
+
+    ASSERT_TRUE(bin.good());
+    ASSERT_GE(t.size(), 5001);
+
+    for(size_t i = 0; i < t.size(); ++i)
+        EXPECT_NEAR(0.01 * i, t[i], 1e-3);
+
+}
+
+
+TEST(PlotTestBasic, SidecarName) {
+
+    std::stringstream sidecar;
+    sim::data::TypedArrayWriter writer(sim::data::ArrayEncoding::FLOAT64);
+    writer.setSidecar(&sidecar, "dir\\\"data\".bin");
+
+    double values[] = {1.0, 2.0};
+    std::string out;
+    writer.write(out, values, 2);
+
+    // the file name is escaped
+    auto j = nlohmann::json::parse(out);
+    EXPECT_EQ("dir\\\"data\".bin", j["file"]);
+    EXPECT_EQ(2, j["length"]);
+    EXPECT_EQ(16, sidecar.str().size());
+
+}
+
+
+TEST_F(PlotTest, Columnar) {
+
+    auto plotFile = sim::fnc::string_format("%s/plot_columnar.json", LOG_DIR);
+
+    // create plot definition with columnar dataset
+    plotLogger.create(plotFile, "Columnar Test");
+    plotLogger.defineDataset({"time", "a", "b"}, {&time, &value1, &value2});
+    plotLogger.setColumnar(300);
+    plotLogger.addFigure("first", "Value 1 over time", "Time t [s]", "Value v [-]", "time", "a");
+
+    // run loop
+    jsonLogger.setFilename(sim::fnc::string_format("%s/data_columnar.json", LOG_DIR));
+    loop.run();
+
+    std::ifstream f(plotFile);
+    auto chunks = nlohmann::json::parse(f)["dataset"]["chunks"];
+
+    ASSERT_EQ(4, chunks.size());
+    EXPECT_EQ(300, chunks[0]["time"].size());
+    EXPECT_EQ(101, chunks[3]["time"].size());
+
+    // concatenate columns
+    std::vector<double> t, a;
+    for(auto &c : chunks) {
+
+        EXPECT_EQ(c["time"].size(), c["b"].size());
+
+        for(auto &v : c["time"])
+            t.push_back(v.get<double>());
+
+        for(auto &v : c["a"])
+            a.push_back(v.get<double>());
+
+    }
+
+    ASSERT_EQ(1001, t.size());
+    for(size_t i = 0; i < t.size(); ++i) {
+        EXPECT_NEAR(0.01 * i, t[i], 1e-6);
+        EXPECT_NEAR(cos(0.02 * i), a[i], 1e-5);
+    }
+
+}
+
+
+TEST_F(PlotTest, ColumnarTyped) {
+
+    auto plotFile = sim::fnc::string_format("%s/plot_columnar_typed.json", LOG_DIR);
+
+    // create plot definition with binary columnar dataset
+    plotLogger.create(plotFile, "Columnar Typed Test");
+    plotLogger.defineDataset({"time", "a"}, {&time, &value1});
+    plotLogger.setColumnar(1000);
+    plotLogger.setEncoding(sim::data::ArrayEncoding::FLOAT64);
+    plotLogger.addFigure("first", "Value 1 over time", "Time t [s]", "Value v [-]", "time", "a");
+
+    // run loop
+    jsonLogger.setFilename(sim::fnc::string_format("%s/data_columnar_typed.json", LOG_DIR));
+    loop.run();
+
+    std::ifstream f(plotFile);
+    auto chunks = nlohmann::json::parse(f)["dataset"]["chunks"];
+
+    ASSERT_EQ(2, chunks.size());
+    EXPECT_EQ("float64", chunks[1]["time"]["dtype"]);
+
+    auto bytes = decodeBase64(chunks[1]["time"]["data"].get<std::string>());
+    ASSERT_EQ(8, bytes.size());
+
+    double t;
+    std::memcpy(&t, bytes.data(), 8);
+    EXPECT_NEAR(10.0, t, 1e-9);
+
+}
@@ -1,4 +1,6 @@
+#include <simcore/data/DataManager.h>
 #include <simcore/data/Registry.h>
+#include <simcore/data/RegistryBridge.h>
 #include <gtest/gtest.h>
 
 #include <sstream>
@@ -191,3 +193,81 @@ TEST(RegistryTest, EntriesIteration) {
   EXPECT_TRUE(entries.count("a"));
   EXPECT_TRUE(entries.count("b"));
 }
+
+// --- Storable bridge ---
+
+class BridgeStorable : public sim::data::IStorable {
+ public:
+  struct Parameters {
+    double mass = 1500.0;
+    int axles = 2;
+  };
+
+  Parameters param;
+  TestState state;
+  std::string name = "unit";
+
+  std::vector<DataEntry> getData(Context context) const override {
+    std::vector<DataEntry> ret;
+    switch (context) {
+      case Context::PARAMETER:
+        ADD(ret, mass, param);
+        ADD(ret, axles, param);
+        ret.emplace_back(sim::data::createDataEntry("name", &name));
+        break;
+      case Context::STATE:
+        ADD(ret, x, state);
+        ADD(ret, velocity, state);
+        break;
+      default:
+        break;
+    }
+    return ret;
+  }
+};
+
+TEST(RegistryTest, PublishStorable) {
+  Registry reg;
+  BridgeStorable store;
+
+  EXPECT_EQ(sim::data::publishStorable(reg, "Unit", store), 5u);
+  EXPECT_EQ(&reg.get<double>("Unit.parameter.mass"), &store.param.mass);
+  EXPECT_EQ(&reg.get<int>("Unit.parameter.axles"), &store.param.axles);
+  EXPECT_EQ(reg.get<std::string>("Unit.parameter.name"), "unit");
+  EXPECT_FALSE(reg.has("Unit.state.y"));
+
+  // snapshots cover the storable
+  store.state.x = 1.0;
+  auto snap = reg.capture();
+  store.state.x = 2.0;
+  reg.restore(snap);
+  EXPECT_DOUBLE_EQ(store.state.x, 1.0);
+}
+
+TEST(RegistryTest, PublishDataManager) {
+  Registry reg;
+  BridgeStorable store;
+
+  sim::data::DataManager data;
+  data.registerStorable("Unit", store);
+
+  EXPECT_EQ(data.publishTo(reg), 5u);
+  EXPECT_EQ(&reg.get<double>("Unit.state.velocity"), &store.state.velocity);
+
+  reg.get<double>("Unit.state.velocity") = 12.0;
+  EXPECT_DOUBLE_EQ(data.getValue<double>("Unit.state.velocity"), 12.0);
+}
+
+TEST(RegistryTest, PublishDataManagerVector) {
+  Registry reg;
+  BridgeStorable first, second;
+
+  sim::data::DataManager data;
+  data.registerStorableVector("Units", {&first, &second});
+
+  // every element is published under its index
+  EXPECT_EQ(data.publishTo(reg), 10u);
+  EXPECT_EQ(&reg.get<double>("Units.0.state.velocity"), &first.state.velocity);
+  EXPECT_EQ(&reg.get<double>("Units.1.state.velocity"), &second.state.velocity);
+  EXPECT_FALSE(reg.has("Units.state.velocity"));
+}
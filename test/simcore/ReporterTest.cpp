@@ -0,0 +1,387 @@
+//
+// Copyright (c) 2019-2020 Jens Klimke <jens.klimke@rwth-aachen.de>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+
+#include <simcore/Loop.h>
+#include <simcore/ISynchronized.h>
+#include <simcore/timers/BasicTimer.h>
+#include <simcore/timers/TimeIsUp.h>
+#include <simcore/data/JsonReporter.h>
+#include <simcore/data/JsonFileReporter.h>
+#include <simcore/data/BinaryReporter.h>
+#include <simcore/data/BinaryReader.h>
+#include <simcore/functions.h>
+#include <nlohmann/json.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <fstream>
+
+
+class ReporterTest : public ::testing::Test, public sim::ISynchronized {
+
+public:
+
+    double value = 0.0;
+    int counter = 0;
+    std::string name = "unit \"1\"";
+
+    // create objects
+    BasicTimer timer;
+    TimeIsUp stop;
+    ::sim::Loop loop;
+
+    void SetUp() override {
+
+        // set parameters
+        timer.setTimeStepSize(0.1);
+        stop.setStopTime(1.0);
+
+        // set timer and stop condition
+        loop.setTimer(&timer);
+        loop.addStopCondition(&stop);
+
+        // models
+        loop.addComponent(&stop);
+        loop.addComponent(this);
+
+    }
+
+
+    void initialize(double initTime) override {
+
+        value = 0.0;
+        counter = 0;
+
+    }
+
+
+    bool step(double simTime) override {
+
+        value += 0.1;
+        counter++;
+
+        return true;
+
+    }
+
+
+    void terminate(double simTime) override {}
+
+};
+
+
+TEST_F(ReporterTest, JsonReporter) {
+
+    std::stringstream ss;
+
+    // create reporter
+    JsonReporter reporter;
+    reporter.setOutstream(ss);
+    reporter.addValue("value", &value);
+    reporter.addValue("counter", &counter);
+    reporter.addValue("name", &name);
+    loop.addComponent(&reporter);
+
+    EXPECT_THROW(reporter.addValue("time", &value), std::invalid_argument);
+
+    // run
+    loop.run();
+
+    // parse output
+    auto j = nlohmann::json::parse(ss.str());
+    ASSERT_EQ(11, j.size());
+
+    // values are written exactly
+    double v = 0.0;
+    for(std::size_t i = 0; i < j.size(); ++i) {
+        v += 0.1;
+        EXPECT_EQ(v, j[i]["value"].get<double>());
+        EXPECT_EQ(i + 1, j[i]["counter"].get<int>());
+        EXPECT_EQ(name, j[i]["name"].get<std::string>());
+    }
+
+    EXPECT_NEAR(1.0, j[10]["time"].get<double>(), 1e-9);
+
+}
+
+
+TEST_F(ReporterTest, JsonReporterRows) {
+
+    std::stringstream ss;
+
+    // create reporter
+    JsonReporter reporter;
+    reporter.setOutstream(ss);
+    reporter.setFormat(JsonReporter::Format::ROWS);
+    reporter.setPrecision(3);
+    reporter.addValue("value", &value);
+    reporter.addValue("counter", &counter);
+    loop.addComponent(&reporter);
+
+    // run
+    loop.run();
+
+    // parse output
+    auto j = nlohmann::json::parse(ss.str());
+    EXPECT_EQ(nlohmann::json({"time", "counter", "value"}), j["keys"]);
+
+    auto &rows = j["rows"];
+    ASSERT_EQ(11, rows.size());
+
+    for(std::size_t i = 0; i < rows.size(); ++i) {
+        ASSERT_EQ(3, rows[i].size());
+        EXPECT_NEAR(0.1 * i, rows[i][0].get<double>(), 1e-9);
+        EXPECT_EQ(i + 1, rows[i][1].get<int>());
+        EXPECT_NEAR(0.1 * (i + 1), rows[i][2].get<double>(), 1e-9);
+    }
+
+    // precision is applied
+    EXPECT_NE(std::string::npos, ss.str().find("[1,11,1.1]"));
+
+}
+
+
+TEST_F(ReporterTest, JsonReporterDeadband) {
+
+    std::stringstream ss;
+
+    // create reporter
+    JsonReporter reporter;
+    reporter.setOutstream(ss);
+    reporter.addValue("value", &value);
+    reporter.addValue("counter", &counter);
+    reporter.addValue("name", &name);
+    reporter.setDeadband("value", 0.25);
+    reporter.setDeadband("counter", 0.0);
+    loop.addComponent(&reporter);
+
+    // run
+    loop.run();
+
+    // all rows are written (counter changes), value only when moved by more than 0.25
+    auto j = nlohmann::json::parse(ss.str());
+    ASSERT_EQ(11, j.size());
+
+    std::vector<double> times;
+    for(auto &row : j) {
+        EXPECT_TRUE(row.contains("counter"));
+        EXPECT_TRUE(row.contains("name"));
+        if(row.contains("value"))
+            times.push_back(row["time"].get<double>());
+    }
+
+    ASSERT_EQ(4, times.size());
+    EXPECT_NEAR(0.0, times[0], 1e-9);
+    EXPECT_NEAR(0.3, times[1], 1e-9);
+    EXPECT_NEAR(0.6, times[2], 1e-9);
+    EXPECT_NEAR(0.9, times[3], 1e-9);
+
+    // unknown keys are rejected
+    reporter.setDeadband("unknown", 1.0);
+    EXPECT_THROW(loop.run(), std::invalid_argument);
+
+}
+
+
+TEST_F(ReporterTest, JsonReporterRowsDeadband) {
+
+    std::stringstream ss;
+
+    // create reporter
+    JsonReporter reporter;
+    reporter.setOutstream(ss);
+    reporter.setFormat(JsonReporter::Format::ROWS);
+    reporter.addValue("value", &value);
+    reporter.setDeadband("value", 0.25);
+    loop.addComponent(&reporter);
+
+    // run
+    loop.run();
+
+    // slow drift is written once it moved beyond the deadband since the last written row
+    auto rows = nlohmann::json::parse(ss.str())["rows"];
+    ASSERT_EQ(5, rows.size());
+    EXPECT_NEAR(0.0, rows[0][0].get<double>(), 1e-9);
+    EXPECT_NEAR(0.3, rows[1][0].get<double>(), 1e-9);
+    EXPECT_NEAR(0.6, rows[2][0].get<double>(), 1e-9);
+    EXPECT_NEAR(0.9, rows[3][0].get<double>(), 1e-9);
+    EXPECT_NEAR(1.0, rows[4][0].get<double>(), 1e-9);
+
+}
+
+
+TEST_F(ReporterTest, JsonReporterKeepAlive) {
+
+    std::stringstream ss;
+
+    // create reporter
+    JsonReporter reporter;
+    reporter.setOutstream(ss);
+    reporter.setFormat(JsonReporter::Format::ROWS);
+    reporter.addValue("value", &value);
+    reporter.addValue("counter", &counter);
+    reporter.setDeadband("value", 10.0);
+    reporter.setKeepAlive(0.45);
+    loop.addComponent(&reporter);
+
+    // run
+    loop.run();
+
+    // only the first row and the keep-alive rows are written
+    auto rows = nlohmann::json::parse(ss.str())["rows"];
+    ASSERT_EQ(3, rows.size());
+    EXPECT_NEAR(0.0, rows[0][0].get<double>(), 1e-9);
+    EXPECT_NEAR(0.5, rows[1][0].get<double>(), 1e-9);
+    EXPECT_NEAR(1.0, rows[2][0].get<double>(), 1e-9);
+    EXPECT_NEAR(1.1, rows[2][2].get<double>(), 1e-9);
+    EXPECT_EQ(11, rows[2][1].get<int>());
+
+}
+
+
+TEST_F(ReporterTest, AsyncJsonFileReporter) {
+
+    auto syncFile = sim::fnc::string_format("%s/reporter_sync.json", LOG_DIR);
+    auto asyncFile = sim::fnc::string_format("%s/reporter_async.json", LOG_DIR);
+
+    // create reporters
+    JsonFileReporter syncReporter, asyncReporter;
+    syncReporter.setFilename(syncFile);
+    asyncReporter.setFilename(asyncFile);
+    asyncReporter.setAsync(2);
+
+    for(auto rep : {&syncReporter, &asyncReporter}) {
+        rep->addValue("value", &value);
+        rep->addValue("counter", &counter);
+        loop.addComponent(rep);
+    }
+
+    // run
+    loop.run();
+
+    // compare files
+    std::ifstream s(syncFile), a(asyncFile);
+    auto js = nlohmann::json::parse(s);
+    auto ja = nlohmann::json::parse(a);
+
+    EXPECT_EQ(11, ja.size());
+    EXPECT_EQ(js, ja);
+    EXPECT_EQ(0, asyncReporter.dropped());
+
+}
+
+
+TEST_F(ReporterTest, AsyncJsonFileReporterDrop) {
+
+    auto file = sim::fnc::string_format("%s/reporter_drop.json", LOG_DIR);
+
+    // create reporter
+    JsonFileReporter reporter;
+    reporter.setFilename(file);
+    reporter.setAsync(1, JsonFileReporter::Overflow::DROP);
+    reporter.addValue("value", &value);
+    loop.addComponent(&reporter);
+
+    // run
+    loop.run();
+
+    // written and dropped rows sum up
+    std::ifstream f(file);
+    auto j = nlohmann::json::parse(f);
+    EXPECT_EQ(11, j.size() + reporter.dropped());
+
+    // strings are not supported
+    JsonFileReporter strReporter;
+    strReporter.setFilename(file);
+    strReporter.setAsync(1);
+    strReporter.addValue("name", &name);
+    loop.addComponent(&strReporter);
+
+    EXPECT_THROW(loop.run(), std::runtime_error);
+
+}
+
+
+TEST_F(ReporterTest, BinaryReporter) {
+
+    using sim::data::BinaryFormat;
+
+    long big = -100000;
+    unsigned int small = 200;
+    bool flag = true;
+
+    // reference reporter
+    std::stringstream js;
+    JsonReporter jsonReporter;
+    jsonReporter.setOutstream(js);
+
+    // binary reporters
+    std::stringstream cs, ms;
+    BinaryReporter cborReporter(BinaryFormat::CBOR), msgpackReporter(BinaryFormat::MSGPACK);
+    cborReporter.setOutstream(cs);
+    msgpackReporter.setOutstream(ms);
+
+    for(auto rep : std::vector<sim::ISynchronized*>{&jsonReporter, &cborReporter, &msgpackReporter})
+        loop.addComponent(rep);
+
+    jsonReporter.addValue("value", &value);
+    jsonReporter.addValue("counter", &counter);
+    jsonReporter.addValue("name", &name);
+    jsonReporter.addValue("big", &big);
+    jsonReporter.addValue("small", &small);
+    jsonReporter.addValue("flag", &flag);
+
+    for(auto rep : {&cborReporter, &msgpackReporter}) {
+        rep->addValue("value", &value);
+        rep->addValue("counter", &counter);
+        rep->addValue("name", &name);
+        rep->addValue("big", &big);
+        rep->addValue("small", &small);
+        rep->addValue("flag", &flag);
+    }
+
+    // run
+    loop.run();
+
+    auto ref = nlohmann::json::parse(js.str());
+    ASSERT_EQ(11, ref.size());
+
+    // read records
+    for(auto p : {std::make_pair(&cs, BinaryFormat::CBOR), std::make_pair(&ms, BinaryFormat::MSGPACK)}) {
+
+        sim::data::BinaryReader reader(*p.first, p.second);
+
+        nlohmann::json record;
+        std::size_t i = 0;
+        while(reader.next(record)) {
+            ASSERT_LT(i, ref.size());
+            EXPECT_EQ(ref[i++], record);
+        }
+
+        EXPECT_EQ(ref.size(), i);
+
+    }
+
+    // records are standard conform
+    EXPECT_EQ(ref[0], nlohmann::json::from_cbor(cs.str(), false));
+    EXPECT_EQ(ref[0], nlohmann::json::from_msgpack(ms.str(), false));
+
+}
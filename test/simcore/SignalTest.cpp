@@ -27,13 +27,22 @@
 #include <simcore/IStopCondition.h>
 #include <simcore/value/SignalCurve.h>
 #include <simcore/value/SignalTube.h>
+#include <simcore/value/UniformSignalCurve.h>
+#include <simcore/value/SignalMap.h>
+#include <simcore/value/FixedSignalCurve.h>
 #include <simcore/value/ValueExceed.h>
+#include <simcore/value/ThresholdSet.h>
 #include <simcore/value/ValueOutOfTube.h>
 #include <simcore/timers/BasicTimer.h>
 #include <simcore/timers/TimeIsUp.h>
 #include <gtest/gtest.h>
 
 
+// all members of both tube instantiations compile
+template class BasicSignalTube<SignalCurve>;
+template class BasicSignalTube<UniformSignalCurve>;
+
+
 TEST(SignalTestBasic, SignalCurve) {
 
     SignalCurve sc;
@@ -114,6 +123,448 @@ TEST(SignalTestBasic, SignalCurve) {
 }
 
 
+TEST(SignalTestBasic, SignalCurveCursor) {
+
+    SignalCurve sc;
+
+    // not strictly monotonous
+    EXPECT_THROW(sc.define({0.0, 1.0, 1.0}, {0.0, 1.0, 2.0}), std::invalid_argument);
+    EXPECT_THROW(sc.define({0.0, 2.0, 1.0}, {0.0, 1.0, 2.0}), std::invalid_argument);
+
+    // define large curve
+    std::vector<double> x, y;
+    for(unsigned int i = 0; i < 10000; ++i) {
+        x.push_back(0.1 * i + 0.001 * (i % 7));
+        y.push_back(sin(0.01 * i));
+    }
+
+    sc.define(std::vector<double>(x), std::vector<double>(y));
+
+    // increasing queries with small and large steps
+    SignalCurve::Cursor cursor;
+    for(double q = -1e-10; q < x.back(); q += (q < 500.0 ? 0.037 : 13.7))
+        EXPECT_DOUBLE_EQ(sc.interpolate(q), sc.interpolate(q, cursor));
+
+    // random queries
+    for(unsigned int i = 0; i < 1000; ++i) {
+
+        auto q = x.back() * ((i * 7919) % 1000) / 1000.0;
+        EXPECT_DOUBLE_EQ(sc.interpolate(q), sc.interpolate(q, cursor));
+
+        auto w0 = sc.where(q);
+        auto w1 = sc.where(q, cursor);
+        EXPECT_DOUBLE_EQ(w0.ds0, w1.ds0);
+        EXPECT_DOUBLE_EQ(w0.ds1, w1.ds1);
+
+    }
+
+    // out of bounds and exact points
+    EXPECT_DOUBLE_EQ(y.front(), sc.where(-5.0, cursor).v0);
+    EXPECT_DOUBLE_EQ(y.back(), sc.where(x.back() + 5.0, cursor).v1);
+    EXPECT_DOUBLE_EQ(y[500], sc.interpolate(x[500], cursor));
+    EXPECT_DOUBLE_EQ(y[501], sc.interpolate(x[501], cursor));
+
+}
+
+
+TEST(SignalTestBasic, SignalCurveBatch) {
+
+    SignalCurve sc;
+    sc.define({0.0, 10.0, 20.0, 30.0}, {1.0, 2.0, 2.0, -1.0});
+
+    // sorted and unsorted queries including points out of bounds
+    std::vector<double> sorted{-1.0, -1e-10, 0.0, 1.0, 5.0, 10.0, 11.0, 20.0, 21.0, 30.0, 30.0 + 1e-10, 31.0};
+    std::vector<double> unsorted{21.0, -1.0, 5.0, 31.0, 0.0, 10.0, 30.0, 1.0};
+
+    for(auto &xs : {sorted, unsorted}) {
+
+        std::vector<double> ys(xs.size());
+        std::vector<std::uint64_t> mask;
+
+        auto count = sc.interpolate(xs.data(), ys.data(), xs.size(), mask);
+
+        EXPECT_EQ(2, count);
+        ASSERT_EQ(1, mask.size());
+
+        for(size_t i = 0; i < xs.size(); ++i) {
+
+            bool out = (mask[0] >> i) & 1u;
+            EXPECT_EQ(xs[i] == -1.0 || xs[i] == 31.0, out);
+
+            if(out)
+                EXPECT_TRUE(std::isnan(ys[i]));
+            else
+                EXPECT_DOUBLE_EQ(sc.interpolate(xs[i]), ys[i]);
+
+        }
+
+    }
+
+    // many points over several blocks
+    std::vector<double> xs(1000), ys(1000);
+    for(size_t i = 0; i < xs.size(); ++i)
+        xs[i] = 0.031 * static_cast<double>(i) - 1.0;
+
+    std::vector<std::uint64_t> mask;
+    auto count = sc.interpolate(xs.data(), ys.data(), xs.size(), mask);
+
+    EXPECT_EQ(16, mask.size());
+
+    size_t expected = 0;
+    for(size_t i = 0; i < xs.size(); ++i) {
+
+        if(sc.isInBounds(xs[i]))
+            EXPECT_DOUBLE_EQ(sc.interpolate(xs[i]), ys[i]);
+        else
+            expected++;
+
+    }
+
+    EXPECT_EQ(expected, count);
+
+}
+
+
+TEST(SignalTestBasic, SignalCurveCubic) {
+
+    SignalCurve sc;
+
+    // natural spline of a sine
+    std::vector<double> x, y;
+    for(unsigned int i = 0; i <= 20; ++i) {
+        x.push_back(0.1 * M_PI * i);
+        y.push_back(sin(0.1 * M_PI * i));
+    }
+
+    sc.define(std::vector<double>(x), std::vector<double>(y), SignalCurve::Interpolation::CUBIC_SPLINE);
+    EXPECT_EQ(SignalCurve::Interpolation::CUBIC_SPLINE, sc.interpolation());
+
+    // points are met, second derivative is zero at the ends
+    for(size_t i = 0; i < x.size(); ++i)
+        EXPECT_NEAR(y[i], sc.interpolate(x[i]), 1e-12);
+
+    EXPECT_NEAR(0.0, sc.secondDerivative(x.front()), 1e-12);
+    EXPECT_NEAR(0.0, sc.secondDerivative(x.back()), 1e-12);
+
+    // values and derivatives between the points
+    for(double q = 0.5; q < 5.5; q += 0.1) {
+        EXPECT_NEAR(sin(q), sc.interpolate(q), 1e-4);
+        EXPECT_NEAR(cos(q), sc.derivative(q), 1e-3);
+        EXPECT_NEAR(-sin(q), sc.secondDerivative(q), 2e-2);
+    }
+
+    // continuous derivatives at the points
+    for(size_t i = 1; i + 1 < x.size(); ++i) {
+        EXPECT_NEAR(sc.derivative(x[i] - 1e-9), sc.derivative(x[i] + 1e-9), 1e-7);
+        EXPECT_NEAR(sc.secondDerivative(x[i] - 1e-9), sc.secondDerivative(x[i] + 1e-9), 1e-7);
+    }
+
+    // batch equals scalar
+    std::vector<double> xs{0.3, 1.7, 6.2, 3.3}, ys(4);
+    std::vector<std::uint64_t> mask;
+    sc.interpolate(xs.data(), ys.data(), xs.size(), mask);
+    for(size_t i = 0; i < xs.size(); ++i)
+        EXPECT_DOUBLE_EQ(sc.interpolate(xs[i]), ys[i]);
+
+    // monotone data: pchip does not overshoot
+    sc.define({0.0, 1.0, 2.0, 3.0, 4.0, 5.0}, {0.0, 0.0, 0.0, 1.0, 1.0, 1.0}, SignalCurve::Interpolation::PCHIP);
+
+    SignalCurve::Cursor cursor;
+    double last = 0.0;
+    for(double q = 0.0; q <= 5.0; q += 0.01) {
+
+        auto v = sc.interpolate(q, cursor);
+
+        EXPECT_GE(v, last - 1e-12);
+        EXPECT_GE(v, -1e-12);
+        EXPECT_LE(v, 1.0 + 1e-12);
+        last = v;
+
+    }
+
+    EXPECT_NEAR(0.0, sc.derivative(1.5), 1e-12);
+    EXPECT_NEAR(0.5, sc.interpolate(2.5), 1e-12);
+    EXPECT_GT(sc.derivative(2.5), 1.0);
+
+    // linear derivatives
+    sc.define({0.0, 10.0, 20.0}, {1.0, 2.0, 0.0});
+    EXPECT_NEAR(0.1, sc.derivative(5.0), 1e-12);
+    EXPECT_NEAR(-0.2, sc.derivative(10.0), 1e-12);
+    EXPECT_DOUBLE_EQ(0.0, sc.secondDerivative(5.0));
+    EXPECT_THROW(sc.derivative(-1.0), std::invalid_argument);
+
+}
+
+
+TEST(SignalTestBasic, SignalTubeEvaluation) {
+
+    SignalTube tube;
+    tube.defineUpper({0.0, 10.0, 20.0, 30.0}, {2.0, 3.0, 3.0,  0.0});
+    tube.defineLower({5.0, 10.0, 20.0, 30.0}, {0.5, 1.0, 1.0, -2.0});
+
+    // trajectory, partly out of the curves
+    std::vector<double> xs, ys;
+    for(unsigned int i = 0; i <= 350; ++i) {
+        xs.push_back(0.1 * i - 1.0);
+        ys.push_back(1.5 + sin(0.1 * i));
+    }
+
+    // missing values within and out of the bounds
+    ys[5] = std::numeric_limits<double>::quiet_NaN();
+    ys[100] = std::numeric_limits<double>::quiet_NaN();
+
+    auto e = tube.evaluate(xs.data(), ys.data(), xs.size());
+
+    ASSERT_EQ(xs.size(), e.lowerMargin.size());
+    ASSERT_EQ(6, e.out.size());
+
+    size_t violations = 0;
+    size_t first = xs.size();
+    for(size_t i = 0; i < xs.size(); ++i) {
+
+        bool out = (e.out[i / 64] >> (i % 64)) & 1u;
+        EXPECT_EQ(!tube.in(xs[i], ys[i]), out);
+
+        if(out) {
+            violations++;
+            first = std::min(first, i);
+        }
+
+        if(std::isnan(ys[i]))
+            continue;
+
+        if(xs[i] >= 5.0 && xs[i] <= 30.0) {
+            EXPECT_NEAR(ys[i] - tube.getValues(xs[i]).first, e.lowerMargin[i], 1e-12);
+            EXPECT_NEAR(tube.getValues(xs[i]).second - ys[i], e.upperMargin[i], 1e-12);
+        } else {
+            EXPECT_TRUE(std::isnan(e.lowerMargin[i]));
+            EXPECT_EQ(xs[i] < 0.0 || xs[i] > 30.0, std::isnan(e.upperMargin[i]));
+        }
+
+    }
+
+    EXPECT_GT(violations, 0);
+    EXPECT_EQ(violations, e.violations);
+    EXPECT_EQ(first, e.firstViolation);
+
+    // NaN values are flagged within the bounds only
+    EXPECT_FALSE((e.out[0] >> 5u) & 1u);
+    EXPECT_TRUE((e.out[1] >> 36u) & 1u);
+
+}
+
+
+TEST(SignalTestBasic, SignalCurveSimplify) {
+
+    // measured curve with many points
+    std::vector<double> x, y;
+    for(unsigned int i = 0; i < 100000; ++i) {
+        x.push_back(0.001 * i);
+        y.push_back(sin(0.001 * i) + (i > 50000 ? 0.5 : 0.0));
+    }
+
+    SignalCurve original, sc;
+    original.define(std::vector<double>(x), std::vector<double>(y));
+    sc.define(std::vector<double>(x), std::vector<double>(y));
+
+    EXPECT_THROW(sc.simplify(-1.0), std::invalid_argument);
+
+    auto dev = sc.simplify(1e-3);
+
+    EXPECT_LT(sc.size(), 1500);
+    EXPECT_GT(dev, 0.0);
+    EXPECT_LE(dev, 1e-3);
+
+    // the reported deviation is the maximum deviation
+    double maxDev = 0.0;
+    for(size_t i = 0; i < x.size(); ++i)
+        maxDev = std::max(maxDev, std::fabs(sc.interpolate(x[i]) - y[i]));
+
+    EXPECT_NEAR(dev, maxDev, 1e-12);
+
+    // the step is kept, end points are kept
+    EXPECT_NEAR(original.interpolate(50.0005), sc.interpolate(50.0005), 1e-3);
+    EXPECT_NEAR(y.back(), sc.interpolate(x.back()), 1e-12);
+
+    // straight lines are reduced to two points
+    SignalTube tube;
+    tube.defineLower({0.0, 1.0, 2.0, 3.0}, {0.0, 1.0, 2.0, 3.0});
+    tube.defineUpper({0.0, 1.0, 2.0, 3.0}, {1.0, 1.0, 1.5, 1.0});
+
+    EXPECT_DOUBLE_EQ(0.0, tube.simplify(0.0));
+    EXPECT_DOUBLE_EQ(0.5, tube.simplify(0.6));
+    EXPECT_NEAR(1.5, tube.center(2.0), 1e-12);
+
+}
+
+
+TEST(SignalTestBasic, SignalCurveSimplifyCubic) {
+
+    // curve with a step, where a refit spline overshoots
+    std::vector<double> x, y;
+    for(unsigned int i = 0; i < 2000; ++i) {
+        x.push_back(0.01 * i);
+        y.push_back(sin(0.01 * i) + (i > 1000 ? 0.5 : 0.0));
+    }
+
+    for(auto mode : {SignalCurve::Interpolation::CUBIC_SPLINE, SignalCurve::Interpolation::PCHIP}) {
+
+        SignalCurve sc;
+        sc.define(std::vector<double>(x), std::vector<double>(y), mode);
+
+        auto dev = sc.simplify(1e-3);
+
+        EXPECT_LT(sc.size(), 400);
+        EXPECT_EQ(mode, sc.interpolation());
+
+        // the refit curve is within the tolerance and the reported deviation is the maximum deviation
+        double maxDev = 0.0;
+        for(size_t i = 0; i < x.size(); ++i)
+            maxDev = std::max(maxDev, std::fabs(sc.interpolate(x[i]) - y[i]));
+
+        EXPECT_LE(maxDev, 1e-3);
+        EXPECT_NEAR(dev, maxDev, 1e-12);
+
+    }
+
+}
+
+
+TEST(SignalTestBasic, UniformSignalCurve) {
+
+    UniformSignalCurve uc;
+    SignalCurve sc;
+
+    EXPECT_FALSE(uc.isSet());
+    EXPECT_THROW(uc.define({0.0, 1.0, 3.0}, {0.0, 1.0, 2.0}), std::invalid_argument);
+    EXPECT_THROW(uc.define(0.0, 0.0, {0.0, 1.0}), std::invalid_argument);
+
+    uc.define({0.0, 10.0, 20.0, 30.0}, {1.0, 2.0, 2.0, -1.0});
+    sc.define({0.0, 10.0, 20.0, 30.0}, {1.0, 2.0, 2.0, -1.0});
+    EXPECT_TRUE(uc.isSet());
+
+    // compare with signal curve
+    for(double x : {-1e-10, 0.0, 1.0, 5.0, 10.0, 11.0, 20.0, 21.0, 29.0, 30.0, 30.0 + 1e-10}) {
+        EXPECT_NEAR(sc.interpolate(x), uc.interpolate(x), EPS_DISTANCE);
+        EXPECT_DOUBLE_EQ(sc.previous(x), uc.previous(x));
+        EXPECT_DOUBLE_EQ(sc.next(x), uc.next(x));
+    }
+
+    EXPECT_DOUBLE_EQ(sc.next(-1.0), uc.next(-1.0));
+    EXPECT_DOUBLE_EQ(sc.previous(35.0), uc.previous(35.0));
+    EXPECT_THROW(uc.interpolate(-1e-4), std::invalid_argument);
+    EXPECT_THROW(uc.interpolate(30.0 + 1e-4), std::invalid_argument);
+
+    // grid points which are not exactly representable
+    uc.define(0.0, 0.1, {0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0});
+    for(unsigned int i = 0; i <= 10; ++i) {
+        EXPECT_DOUBLE_EQ(i, uc.previous(0.1 * i));
+        EXPECT_NEAR(i, uc.interpolate(0.1 * i), 1e-9);
+    }
+
+    // batch
+    std::vector<double> xs{-1.0, 0.05, 0.55, 2.0}, ys(4);
+    std::vector<std::uint64_t> mask;
+    EXPECT_EQ(2, uc.interpolate(xs.data(), ys.data(), xs.size(), mask));
+    EXPECT_EQ(9u, mask[0]);
+    EXPECT_NEAR(0.5, ys[1], 1e-9);
+    EXPECT_NEAR(5.5, ys[2], 1e-9);
+
+    // uniform tube
+    UniformSignalTube tube;
+    tube.defineLower({0.0, 1.0, 2.0}, {0.0, 1.0, 2.0});
+    tube.defineUpper({0.0, 1.0, 2.0}, {1.0, 2.0, 3.0});
+
+    UniformSignalTube::Cursor cursor;
+    EXPECT_TRUE(tube.in(0.5, 1.0, cursor));
+    EXPECT_FALSE(tube.in(1.5, 0.9, cursor));
+    EXPECT_FALSE(tube.in(1.5, 2.6, cursor));
+    EXPECT_NEAR(2.0, tube.center(1.5), 1e-9);
+
+}
+
+
+TEST(SignalTestBasic, SignalMap) {
+
+    SignalMap map;
+    EXPECT_FALSE(map.isSet());
+
+    EXPECT_THROW(map.define({0.0, 1.0}, {0.0, 1.0}, {0.0, 1.0, 2.0}), std::invalid_argument);
+    EXPECT_THROW(map.define({0.0, 0.0}, {0.0, 1.0}, {0.0, 1.0, 2.0, 3.0}), std::invalid_argument);
+
+    // z = 2 x + 3 y + x y (bilinear, exactly reproduced)
+    std::vector<double> x{0.0, 1.0, 3.0, 6.0}, y{-1.0, 0.0, 2.0}, z;
+    for(auto xi : x)
+        for(auto yj : y)
+            z.push_back(2.0 * xi + 3.0 * yj + xi * yj);
+
+    map.define(std::move(x), std::move(y), std::move(z));
+    EXPECT_TRUE(map.isSet());
+
+    auto f = [] (double x, double y) { return 2.0 * x + 3.0 * y + x * y; };
+
+    SignalMap::Cursor cursor;
+    for(double xi = 0.0; xi <= 6.0; xi += 0.25) {
+        for(double yj = -1.0; yj <= 2.0; yj += 0.25) {
+            EXPECT_NEAR(f(xi, yj), map.interpolate(xi, yj), 1e-12);
+            EXPECT_NEAR(f(xi, yj), map.interpolate(xi, yj, cursor), 1e-12);
+        }
+    }
+
+    EXPECT_TRUE(map.isInBounds(6.0, 2.0));
+    EXPECT_FALSE(map.isInBounds(6.1, 2.0));
+    EXPECT_NEAR(f(6.0, 2.0), map.interpolate(6.0 + 1e-10, 2.0), 1e-8);
+    EXPECT_THROW(map.interpolate(-1e-4, 0.0), std::invalid_argument);
+    EXPECT_THROW(map.interpolate(0.0, 2.0 + 1e-4), std::invalid_argument);
+
+    // batch
+    std::vector<double> xs{0.5, 5.0, 7.0, 2.0, 0.0}, ys{0.5, 1.0, 0.0, -2.0, 2.0}, zs(5);
+    std::vector<std::uint64_t> mask;
+
+    EXPECT_EQ(2, map.interpolate(xs.data(), ys.data(), zs.data(), xs.size(), mask));
+    EXPECT_EQ(12u, mask[0]);
+
+    for(size_t i : {0, 1, 4})
+        EXPECT_NEAR(f(xs[i], ys[i]), zs[i], 1e-12);
+
+    EXPECT_TRUE(std::isnan(zs[2]));
+    EXPECT_TRUE(std::isnan(zs[3]));
+
+}
+
+
+TEST(SignalTestBasic, FixedSignalCurve) {
+
+    // evaluated at compile time
+    constexpr auto fc = makeFixedSignalCurve({0.0, 10.0, 20.0, 30.0}, {1.0, 2.0, 2.0, -1.0});
+
+    static_assert(fc.size() == 4, "size");
+    static_assert(fc.interpolate(5.0) == 1.5, "interpolate");
+    static_assert(fc.interpolate(30.0) == -1.0, "interpolate at end");
+    static_assert(fc.previous(10.0) == 2.0, "previous");
+    static_assert(fc.next(20.0) == -1.0, "next");
+    static_assert(fc.hit(21.0, 1.7), "hit");
+    static_assert(fc.isInBounds(0.0) && !fc.isInBounds(30.1), "bounds");
+
+    // same semantics as signal curve
+    SignalCurve sc;
+    sc.define({0.0, 10.0, 20.0, 30.0}, {1.0, 2.0, 2.0, -1.0});
+
+    for(double x = -1e-10; x <= 30.0; x += 0.5) {
+        EXPECT_DOUBLE_EQ(sc.interpolate(x), fc.interpolate(x));
+        EXPECT_DOUBLE_EQ(sc.previous(x), fc.previous(x));
+        EXPECT_DOUBLE_EQ(sc.next(x), fc.next(x));
+    }
+
+    EXPECT_THROW(fc.interpolate(-1e-4), std::invalid_argument);
+    EXPECT_THROW(fc.next(30.0 + 1e-4), std::invalid_argument);
+
+    // invalid definition at runtime (a compile error in constant expressions)
+    EXPECT_THROW(makeFixedSignalCurve({0.0, 1.0, 1.0}, {0.0, 1.0, 2.0}), std::invalid_argument);
+
+}
+
+
 TEST(SignalTestBasic, SignalTube) {
 
     SignalTube sc;
@@ -245,6 +696,11 @@ TEST_F(SignalTest, ValueExceed) {
     EXPECT_DOUBLE_EQ(6.0, timer.time());
     EXPECT_DOUBLE_EQ(49.0, value);
 
+    // the crossing is interpolated between the samples 25 and 36
+    EXPECT_TRUE(ex.event().valid);
+    EXPECT_NEAR(5.0 + 0.1 / 11.0, ex.event().time, 1e-9);
+    EXPECT_DOUBLE_EQ(25.1, ex.event().value);
+
 
     // change mode
     ex.setValueAndLimit(&value, 25.1);
@@ -264,6 +720,106 @@ TEST_F(SignalTest, ValueExceed) {
     EXPECT_EQ(ex.getCode(), ::sim::IStopCondition::StopCode::NONE);
     EXPECT_EQ(10.0, timer.time());
     EXPECT_DOUBLE_EQ(121.0, value);
+    EXPECT_FALSE(ex.event().valid);
+
+    // the time condition reports the stop time
+    EXPECT_TRUE(stop.event().valid);
+    EXPECT_DOUBLE_EQ(10.0, stop.event().time);
+
+
+    // coarse steps, the crossing is between the samples 1 (t = 3) and 4 (t = 6)
+    timer.setTimeStepSize(3.0);
+    ex.setValueAndLimit(&value, 2.5);
+
+    sim.run();
+    EXPECT_EQ(ex.getCode(), ::sim::IStopCondition::StopCode::SIM_ENDED);
+    EXPECT_DOUBLE_EQ(6.0, timer.time());
+    EXPECT_NEAR(4.5, ex.event().time, 1e-9);
+    EXPECT_DOUBLE_EQ(2.5, ex.event().value);
+
+    // the stop time is reported, although the time step is exceeded
+    ex.setValueAndLimit(&value, 1e3);
+
+    sim.run();
+    EXPECT_EQ(stop.getCode(), ::sim::IStopCondition::StopCode::SIM_ENDED);
+    EXPECT_DOUBLE_EQ(12.0, timer.time());
+    EXPECT_DOUBLE_EQ(10.0, stop.event().time);
+
+}
+
+
+TEST(SignalTestBasic, ValueExceedNonArithmetic) {
+
+    std::string value = "a";
+
+    ValueExceed<std::string> ex;
+    ex.setValueAndLimit(&value, "m");
+    ex.initialize(0.0);
+
+    ex.step(0.0);
+    EXPECT_FALSE(ex.hasStopped());
+
+    // the time of the step is recorded, no value
+    value = "z";
+    ex.step(1.0);
+
+    EXPECT_TRUE(ex.hasStopped());
+    EXPECT_TRUE(ex.event().valid);
+    EXPECT_DOUBLE_EQ(1.0, ex.event().time);
+    EXPECT_TRUE(std::isnan(ex.event().value));
+
+}
+
+
+TEST_F(SignalTest, ThresholdSet) {
+
+    double other = 0.0;
+
+    // check values against limits
+    ThresholdSet set;
+    set.addLower(&other, -1.0, ThresholdSet::Mode::OBJECTIVES_MISSED);
+    set.add(&x, -1.0, 100.0);
+    auto idx = set.addUpper(&value, 25.1, ThresholdSet::Mode::OBJECTIVES_MISSED);
+
+    EXPECT_EQ(3, set.size());
+    EXPECT_EQ(2, idx);
+
+    // inverted and NaN limits are rejected
+    EXPECT_THROW(set.add(&other, 1.0, -1.0), std::invalid_argument);
+    EXPECT_THROW(set.addUpper(&other, std::numeric_limits<double>::quiet_NaN()), std::invalid_argument);
+    EXPECT_EQ(3, set.size());
+
+    // add to sim
+    sim.addComponent(&set);
+    sim.addStopCondition(&set);
+
+    // add value limiter
+    sim.addComponent(this);
+
+    // run sim (same as value exceed)
+    sim.run();
+    EXPECT_EQ(set.getCode(), ::sim::IStopCondition::StopCode::OBJECTIVES_MISSED);
+    EXPECT_DOUBLE_EQ(6.0, timer.time());
+    EXPECT_DOUBLE_EQ(49.0, value);
+
+    // check trip
+    EXPECT_EQ(ThresholdSet::Limit::UPPER, set.trip().limit);
+    EXPECT_EQ(2, set.trip().index);
+    EXPECT_DOUBLE_EQ(25.1, set.trip().value);
+    EXPECT_NEAR(timer.time() - 1.0 + 0.1 / 11.0, set.trip().time, 1e-9);
+    EXPECT_TRUE(set.event().valid);
+    EXPECT_DOUBLE_EQ(set.trip().time, set.event().time);
+    EXPECT_EQ(ThresholdSet::Limit::NONE, set.state(0));
+    EXPECT_EQ(ThresholdSet::Limit::UPPER, set.state(2));
+
+    // lower limit, the first value tripped is reported
+    other = -2.0;
+
+    sim.run();
+    EXPECT_EQ(set.getCode(), ::sim::IStopCondition::StopCode::OBJECTIVES_MISSED);
+    EXPECT_EQ(ThresholdSet::Limit::LOWER, set.trip().limit);
+    EXPECT_EQ(0, set.trip().index);
+    EXPECT_DOUBLE_EQ(-2.0, set.trip().value);
 
 }
 
@@ -292,6 +848,11 @@ TEST_F(SignalTest, OutOfTube) {
     EXPECT_EQ(2.0, timer.time());
     EXPECT_DOUBLE_EQ(9.0, value);
 
+    // the first violation is recorded
+    EXPECT_TRUE(tube.event().valid);
+    EXPECT_DOUBLE_EQ(2.0, tube.event().time);
+    EXPECT_DOUBLE_EQ(4.0, tube.event().value);
+
 
     // change limits
     tube.defineLower({0.0, 2.5, 5.0, 7.5, 10.0}, {-0.1, 0.0,   6.25, 25.0,   56.25});